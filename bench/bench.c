@@ -0,0 +1,730 @@
+#include "game.h"
+#include "arena.h"
+#include "snake.h"
+#include "food.h"
+#include "grid.h"
+#include "ui.h"
+#include "headless.h"
+#include "autopilot.h"
+#include "hamilton.h"
+#include "bitboard.h"
+#include "distance_field.h"
+#include "mcts.h"
+#include "utils.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Board used by every benchmark: 200x60 interior cells
+#define BENCH_BOARD_WIDTH   202
+#define BENCH_BOARD_HEIGHT  62
+#define BENCH_SAMPLES       200
+
+// Board used by the reachability benchmarks, border included
+#define BENCH_FLOOD_WIDTH   256
+#define BENCH_FLOOD_HEIGHT  128
+
+// Board and positions used by the tree search benchmarks, border included
+#define BENCH_SEARCH_WIDTH  24
+#define BENCH_SEARCH_HEIGHT 16
+#define BENCH_SEARCH_SEED   7
+#define BENCH_SEARCH_TABLE_BITS 16
+
+// Heap check: ticks played per bot after the level start
+#define BENCH_HEAP_TICKS    2000
+#define BENCH_HEAP_MCTS_THREADS 4   // Search threads, so waking them is counted too
+
+// One benchmark measurement
+typedef struct {
+    const char* name;
+    int snake_length;
+    double fill;            // Fraction of interior cells covered by the snake
+    int ops_per_sample;
+    double samples[BENCH_SAMPLES]; // ns per operation for each sample
+} bench_result_t;
+
+// Benchmark fixture: a game whose snake is laid along a Hamiltonian cycle
+// of the board interior, so it can move forever without dying
+typedef struct {
+    game_t* game;
+    point_t* cycle;
+    int cycle_length;
+    int head_index;         // Position of the snake head on the cycle
+} bench_fixture_t;
+
+// Reachability fixture: the same board as a bitboard and as a byte grid
+// searched cell by cell with a generation-stamped BFS
+typedef struct {
+    bitboard_t* board;
+    unsigned char* blocked;
+    uint32_t* stamps;
+    uint32_t generation;
+    int* queue;
+    double fill;            // Fraction of interior cells blocked
+} bench_flood_t;
+
+// Keeps results observable so the compiler cannot drop the work
+static volatile long bench_sink;
+
+static bench_flood_t bench_flood;
+
+// Heap calls made by the whole process, libc and ncurses included, from
+// any thread. The benchmark replaces glibc's allocator entry points with
+// counting wrappers around the real implementations; elsewhere the check
+// is skipped.
+#ifdef __GLIBC__
+#define BENCH_COUNT_HEAP 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void* ptr);
+
+static long bench_heap_calls;
+
+#define BENCH_COUNT_HEAP_CALL() __atomic_fetch_add(&bench_heap_calls, 1, __ATOMIC_RELAXED)
+
+void* malloc(size_t size) {
+    BENCH_COUNT_HEAP_CALL();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    BENCH_COUNT_HEAP_CALL();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    BENCH_COUNT_HEAP_CALL();
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr) BENCH_COUNT_HEAP_CALL();
+    __libc_free(ptr);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    BENCH_COUNT_HEAP_CALL();
+    void* memory = __libc_memalign(alignment, size);
+    if (!memory) return ENOMEM;
+    *ptr = memory;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    BENCH_COUNT_HEAP_CALL();
+    return __libc_memalign(alignment, size);
+}
+#else
+#define BENCH_COUNT_HEAP 0
+static long bench_heap_calls;
+#endif
+
+/******************************************************************************
+ * @brief 生成棋盘内部的哈密顿回路
+ * 
+ * 内部高度为偶数时：第 0 列留作回程，其余列按行蛇形遍历，
+ * 最后沿第 0 列返回起点
+ * 
+ * @param game 游戏实例指针
+ * @param cycle 输出回路数组，长度为内部格子数
+ * @return int 回路长度
+ *****************************************************************************/
+static int bench_build_cycle(game_t* game, point_t* cycle) {
+    int width = game->board_width - 2;
+    int height = game->board_height - 2;
+    int ox = game->board_offset_x + 1;
+    int oy = game->board_offset_y + 1;
+    int n = 0;
+
+    for (int y = 0; y < height; y++) {
+        if (y % 2 == 0) {
+            for (int x = 1; x < width; x++) cycle[n++] = point_create(ox + x, oy + y);
+        } else {
+            for (int x = width - 1; x >= 1; x--) cycle[n++] = point_create(ox + x, oy + y);
+        }
+    }
+    for (int y = height - 1; y >= 0; y--) {
+        cycle[n++] = point_create(ox, oy + y);
+    }
+
+    return n;
+}
+
+/******************************************************************************
+ * @brief 创建基准测试夹具
+ * 
+ * 蛇占据回路上的前 length 个格子，头部在第 length - 1 个
+ * 
+ * @param fixture 夹具指针
+ * @param length 蛇长度
+ *****************************************************************************/
+static void bench_fixture_init(bench_fixture_t* fixture, int length) {
+    game_t* game = game_create();
+    game->renderer = get_headless_renderer();
+    game_set_board_size(game, BENCH_BOARD_WIDTH, BENCH_BOARD_HEIGHT);
+    game_change_level(game, 1);
+
+    fixture->game = game;
+    fixture->cycle = malloc(sizeof(point_t) * game->board_width * game->board_height);
+    fixture->cycle_length = bench_build_cycle(game, fixture->cycle);
+
+    if (length < 1) length = 1;
+    if (length > fixture->cycle_length - 1) length = fixture->cycle_length - 1;
+
+    point_t head = fixture->cycle[length - 1];
+    snake_reset_position(game->snake, head.x, head.y, DIR_RIGHT);
+    for (int i = length - 2; i >= 0; i--) {
+        snake_add_segment(game->snake, fixture->cycle[i]);
+    }
+    fixture->head_index = length - 1;
+
+    food_spawn(game->food, game);
+}
+
+/******************************************************************************
+ * @brief 释放基准测试夹具
+ * 
+ * @param fixture 夹具指针
+ *****************************************************************************/
+static void bench_fixture_destroy(bench_fixture_t* fixture) {
+    game_destroy(fixture->game);
+    free(fixture->cycle);
+}
+
+/******************************************************************************
+ * @brief 沿回路让蛇前进一步
+ * 
+ * @param fixture 夹具指针
+ *****************************************************************************/
+static void bench_fixture_step(bench_fixture_t* fixture) {
+    snake_t* snake = fixture->game->snake;
+    point_t head = fixture->cycle[fixture->head_index];
+    int next_index = (fixture->head_index + 1) % fixture->cycle_length;
+    point_t next = fixture->cycle[next_index];
+
+    direction_t dir = next.x > head.x ? DIR_RIGHT :
+                      next.x < head.x ? DIR_LEFT :
+                      next.y > head.y ? DIR_DOWN : DIR_UP;
+    snake_set_direction(snake, dir);
+    snake_move_normal(snake, fixture->game);
+    fixture->head_index = next_index;
+}
+
+/******************************************************************************
+ * @brief 创建泛洪填充基准的棋盘
+ * 
+ * 空旷棋盘只有边框；走廊棋盘每隔 4 列竖一道墙，上下交替留出缺口，
+ * 可达区域是一条来回折返的长走廊，是逐行扫描最不利的形状
+ * 
+ * @param corridors 是否加入走廊墙
+ *****************************************************************************/
+static void bench_flood_init(bool corridors) {
+    int width = BENCH_FLOOD_WIDTH;
+    int height = BENCH_FLOOD_HEIGHT;
+    int walls = 0;
+
+    bench_flood.board = bitboard_create(width, height, NULL);
+    if (corridors) {
+        for (int x = 4; x < width - 1; x += 4) {
+            int gap = (x / 4) % 2 == 0 ? 1 : height - 2;
+            for (int y = 1; y < height - 1; y++) {
+                if (y == gap) continue;
+                bitboard_set(bench_flood.board, x, y);
+                walls++;
+            }
+        }
+    }
+    bench_flood.fill = (double)walls / ((width - 2) * (height - 2));
+
+    bench_flood.blocked = malloc((size_t)width * height);
+    bench_flood.stamps = calloc((size_t)width * height, sizeof(uint32_t));
+    bench_flood.queue = malloc(sizeof(int) * width * height);
+    bench_flood.generation = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bench_flood.blocked[y * width + x] = bitboard_test(bench_flood.board, x, y);
+        }
+    }
+}
+
+static void bench_flood_destroy(void) {
+    bitboard_destroy(bench_flood.board);
+    free(bench_flood.blocked);
+    free(bench_flood.stamps);
+    free(bench_flood.queue);
+}
+
+// Individual benchmark bodies, each runs `ops` operations
+static void bench_op_move(bench_fixture_t* fixture, int ops) {
+    for (int i = 0; i < ops; i++) {
+        bench_fixture_step(fixture);
+    }
+}
+
+static void bench_op_collision(bench_fixture_t* fixture, int ops) {
+    long hits = 0;
+    for (int i = 0; i < ops; i++) {
+        hits += snake_check_collision_normal(fixture->game->snake, fixture->game);
+    }
+    bench_sink += hits;
+}
+
+static void bench_op_contains(bench_fixture_t* fixture, int ops) {
+    long hits = 0;
+    for (int i = 0; i < ops; i++) {
+        point_t p = fixture->cycle[(i * 7919) % fixture->cycle_length];
+        hits += snake_contains_point(fixture->game->snake, p);
+    }
+    bench_sink += hits;
+}
+
+static void bench_op_food(bench_fixture_t* fixture, int ops) {
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        point_t p = food_find_valid_position(fixture->game);
+        sum += p.x + p.y;
+    }
+    bench_sink += sum;
+}
+
+// One autopilot decision per tick; the snake then keeps following the cycle
+static void bench_op_autopilot(bench_fixture_t* fixture, int ops) {
+    controller_t* autopilot = get_autopilot_controller();
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        autopilot->steer(fixture->game);
+        sum += fixture->game->snake->turn_queue_count;
+        snake_clear_turns(fixture->game->snake);
+        bench_fixture_step(fixture);
+    }
+    bench_sink += sum;
+}
+
+// One Hamiltonian-cycle decision per tick
+static void bench_op_hamilton(bench_fixture_t* fixture, int ops) {
+    controller_t* hamilton = get_hamilton_controller();
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        hamilton->steer(fixture->game);
+        sum += fixture->game->snake->turn_queue_count;
+        snake_clear_turns(fixture->game->snake);
+        bench_fixture_step(fixture);
+    }
+    bench_sink += sum;
+}
+
+// Reachable area from a corner with the bitboard kernel selected on the board
+static void bench_op_flood_bitboard(bench_fixture_t* fixture, int ops) {
+    (void)fixture;
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        sum += bitboard_flood_fill(bench_flood.board, 1, 1);
+    }
+    bench_sink += sum;
+}
+
+// The same query answered cell by cell, as the autopilot's searches do
+static void bench_op_flood_bfs(bench_fixture_t* fixture, int ops) {
+    (void)fixture;
+    static const int steps[4] = {-BENCH_FLOOD_WIDTH, BENCH_FLOOD_WIDTH, -1, 1};
+    long sum = 0;
+
+    for (int i = 0; i < ops; i++) {
+        uint32_t generation = ++bench_flood.generation;
+        int* queue = bench_flood.queue;
+        int start = BENCH_FLOOD_WIDTH + 1;
+        int head = 0;
+        int tail = 0;
+
+        bench_flood.stamps[start] = generation;
+        queue[tail++] = start;
+        while (head < tail) {
+            int cell = queue[head++];
+            for (int d = 0; d < 4; d++) {
+                int next = cell + steps[d];
+                if (bench_flood.blocked[next] || bench_flood.stamps[next] == generation) continue;
+                bench_flood.stamps[next] = generation;
+                queue[tail++] = next;
+            }
+        }
+        sum += tail;
+    }
+    bench_sink += sum;
+}
+
+/******************************************************************************
+ * @brief 为夹具准备以食物为目标的距离场
+ * 
+ * 距离场关联到网格，之后蛇每走一步都会增量更新
+ * 
+ * @param fixture 夹具指针
+ * @return distance_field_t* 距离场指针
+ *****************************************************************************/
+static distance_field_t* bench_fixture_distance_field(bench_fixture_t* fixture) {
+    game_t* game = fixture->game;
+    if (!game->food_distance) {
+        game->food_distance = distance_field_create(game->grid->width, game->grid->height,
+                                                    game->arena);
+        grid_attach_distance_field(game->grid, game->food_distance);
+        distance_field_set_target(game->food_distance,
+                                  grid_cell_index(game->grid, game->food->position));
+    }
+    return game->food_distance;
+}
+
+// One snake step, then the food distance of the head rebuilt with a full BFS
+static void bench_op_distance_full(bench_fixture_t* fixture, int ops) {
+    distance_field_t* field = bench_fixture_distance_field(fixture);
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        bench_fixture_step(fixture);
+        distance_field_recompute(field);
+        sum += distance_field_get(field, grid_cell_index(fixture->game->grid,
+                                  fixture->cycle[fixture->head_index]));
+    }
+    bench_sink += sum;
+}
+
+// One snake step, the field following the head and tail incrementally
+static void bench_op_distance_incremental(bench_fixture_t* fixture, int ops) {
+    distance_field_t* field = bench_fixture_distance_field(fixture);
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        bench_fixture_step(fixture);
+        sum += distance_field_get(field, grid_cell_index(fixture->game->grid,
+                                  fixture->cycle[fixture->head_index]));
+    }
+    bench_sink += sum;
+}
+
+// Cycle precomputation done at the start of every game
+static void bench_op_hamilton_create(bench_fixture_t* fixture, int ops) {
+    long sum = 0;
+    for (int i = 0; i < ops; i++) {
+        hamilton_t* hamilton = hamilton_create(fixture->game->board_width,
+                                               fixture->game->board_height, NULL);
+        sum += hamilton->cycle_length;
+        hamilton_destroy(hamilton);
+    }
+    bench_sink += sum;
+}
+
+// One snake step followed by an incremental render of the changed cells
+static void bench_op_render_incremental(bench_fixture_t* fixture, int ops) {
+    for (int i = 0; i < ops; i++) {
+        bench_fixture_step(fixture);
+        ui_render_game_screen(fixture->game);
+    }
+}
+
+static void bench_op_render_full(bench_fixture_t* fixture, int ops) {
+    for (int i = 0; i < ops; i++) {
+        ui_invalidate();
+        ui_render_game_screen(fixture->game);
+    }
+}
+
+/******************************************************************************
+ * @brief 运行一个基准测试
+ * 
+ * 每个样本执行 ops_per_sample 次操作并记录平均每次耗时
+ * 
+ * @param result 输出结果
+ * @param name 基准名称
+ * @param length 蛇长度
+ * @param ops_per_sample 每个样本的操作次数
+ * @param op 基准操作函数
+ *****************************************************************************/
+static void bench_run(bench_result_t* result, const char* name, int length,
+                      int ops_per_sample, void (*op)(bench_fixture_t*, int)) {
+    bench_fixture_t fixture;
+    bench_fixture_init(&fixture, length);
+
+    result->name = name;
+    result->snake_length = fixture.game->snake->length;
+    result->fill = (double)result->snake_length / fixture.cycle_length;
+    result->ops_per_sample = ops_per_sample;
+
+    ui_invalidate();
+    op(&fixture, ops_per_sample); // Warm up
+
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        int64_t start = time_now_ns();
+        op(&fixture, ops_per_sample);
+        result->samples[s] = (double)(time_now_ns() - start) / ops_per_sample;
+    }
+
+    bench_fixture_destroy(&fixture);
+}
+
+static int bench_compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/******************************************************************************
+ * @brief 获取已排序样本的百分位数
+ * 
+ * @param sorted 已排序的样本
+ * @param count 样本数
+ * @param percentile 百分位（0-100）
+ * @return double 百分位数
+ *****************************************************************************/
+static double bench_percentile(const double* sorted, int count, double percentile) {
+    int index = (int)(percentile / 100.0 * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+/******************************************************************************
+ * @brief 输出一个基准结果（终端表格 + CSV 行）
+ * 
+ * @param result 基准结果
+ * @param csv CSV 文件，可为 NULL
+ *****************************************************************************/
+static void bench_report(bench_result_t* result, FILE* csv) {
+    double sorted[BENCH_SAMPLES];
+    memcpy(sorted, result->samples, sizeof(sorted));
+    qsort(sorted, BENCH_SAMPLES, sizeof(double), bench_compare_double);
+
+    double mean = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) mean += sorted[i];
+    mean /= BENCH_SAMPLES;
+
+    double p50 = bench_percentile(sorted, BENCH_SAMPLES, 50);
+    double p90 = bench_percentile(sorted, BENCH_SAMPLES, 90);
+    double p99 = bench_percentile(sorted, BENCH_SAMPLES, 99);
+
+    printf("%-28s len=%-6d fill=%5.3f  p50=%10.1f  p90=%10.1f  p99=%10.1f ns/op\n",
+           result->name, result->snake_length, result->fill, p50, p90, p99);
+
+    if (csv) {
+        fprintf(csv, "%s,%d,%.4f,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                result->name, result->snake_length, result->fill, BENCH_SAMPLES,
+                result->ops_per_sample, mean, sorted[0], p50, p90, p99,
+                sorted[BENCH_SAMPLES - 1]);
+    }
+}
+
+/******************************************************************************
+ * @brief 在两种棋盘上对比逐格 BFS 与各个位棋盘泛洪填充实现
+ * 
+ * 只测当前 CPU 支持的实现；结果中蛇长度为 0，填充率为被墙占据的比例
+ * 
+ * @param csv CSV 文件
+ *****************************************************************************/
+static void bench_run_flood(FILE* csv) {
+    static const char* boards[] = {"open", "corridors"};
+    bitboard_kernel_t best = bitboard_best_kernel();
+    char name[64];
+    bench_result_t result;
+
+    for (int b = 0; b < 2; b++) {
+        bench_flood_init(b == 1);
+
+        snprintf(name, sizeof(name), "flood_fill_bfs_%s", boards[b]);
+        bench_run(&result, name, 1, 10, bench_op_flood_bfs);
+        result.snake_length = 0;
+        result.fill = bench_flood.fill;
+        bench_report(&result, csv);
+
+        for (int k = BITBOARD_KERNEL_SCALAR; k <= (int)best; k++) {
+            bench_flood.board->kernel = (bitboard_kernel_t)k;
+            snprintf(name, sizeof(name), "flood_fill_%s_%s",
+                     bitboard_kernel_name((bitboard_kernel_t)k), boards[b]);
+            bench_run(&result, name, 1, 10, bench_op_flood_bitboard);
+            result.snake_length = 0;
+            result.fill = bench_flood.fill;
+            bench_report(&result, csv);
+        }
+
+        bench_flood_destroy();
+    }
+}
+
+/******************************************************************************
+ * @brief 在录制的局面序列上测一次树搜索决策的耗时
+ * 
+ * 固定种子的对局由自动驾驶推进，每个样本在下一个局面上做一次单线程
+ * 搜索，因此有无置换表的两次测量面对完全相同的局面。置换表在整局中
+ * 保留，与游戏中的用法一致。结果中蛇长度为最后一个局面的长度
+ * 
+ * @param result 基准结果
+ * @param name 基准名称
+ * @param table_bits 置换表大小，0 表示不使用
+ * @param csv CSV 文件
+ *****************************************************************************/
+static void bench_run_search(bench_result_t* result, const char* name, int table_bits, FILE* csv) {
+    game_t* game = game_create();
+    game->renderer = get_headless_renderer();
+    game->controller = get_autopilot_controller();
+    game_set_board_size(game, BENCH_SEARCH_WIDTH, BENCH_SEARCH_HEIGHT);
+    game_set_seed(game, BENCH_SEARCH_SEED);
+    game_change_level(game, 1);
+
+    mcts_t* mcts = mcts_create(game->grid->width, game->grid->height, 1,
+                               MCTS_DEFAULT_ROLLOUTS, table_bits);
+    mcts_seed(mcts, BENCH_SEARCH_SEED);
+
+    result->name = name;
+    result->ops_per_sample = 1;
+
+    direction_t dir;
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        int64_t start = time_now_ns();
+        mcts_choose_direction(mcts, game, &dir);
+        result->samples[s] = (double)(time_now_ns() - start);
+        bench_sink += dir;
+
+        if (game_tick(game)) {
+            game_change_level(game, 1);
+            transposition_table_clear(mcts->table);
+        }
+    }
+
+    result->snake_length = game->snake->length;
+    result->fill = (double)result->snake_length / ((game->grid->width - 2) * (game->grid->height - 2));
+    bench_report(result, csv);
+    printf("%-28s %.0f rollouts/sec", "", mcts->total_rollouts / (mcts->search_ns / 1e9));
+    if (mcts->table_probes > 0) {
+        printf(", %.1f%% of leaves reused a table value", 100.0 * mcts->table_hits / mcts->table_probes);
+    }
+    printf("\n");
+
+    mcts_destroy(mcts);
+    game_destroy(game);
+}
+
+/******************************************************************************
+ * @brief 检查节拍路径不调用堆分配
+ * 
+ * 每种电脑玩家先开始一关（内存池在此分配），再计数之后若干节拍中
+ * 整个进程（所有线程）的堆调用次数。死亡后的重新开局只重置内存池，
+ * 同样计入。树搜索使用多个线程，检查唤醒常驻线程也不分配内存
+ * 
+ * @return bool 所有电脑玩家的节拍都没有堆调用返回 true
+ *****************************************************************************/
+static bool bench_run_heap_check(void) {
+    static const bot_mode_t bots[] = {BOT_NONE, BOT_AUTOPILOT, BOT_HAMILTON, BOT_GREEDY, BOT_MCTS};
+    static const char* names[] = {"none", "autopilot", "hamilton", "greedy", "mcts"};
+    bool passed = true;
+
+    if (!BENCH_COUNT_HEAP) {
+        printf("heap check skipped: allocator counting needs glibc\n");
+        return true;
+    }
+
+    for (size_t i = 0; i < sizeof(bots) / sizeof(bots[0]); i++) {
+        game_t* game = game_create();
+        game->renderer = get_headless_renderer();
+        game->options.mcts_threads = BENCH_HEAP_MCTS_THREADS;
+        game->options.mcts_rollouts = 64;
+        game->controller = get_bot_controller(bots[i]);
+        game_set_board_size(game, BENCH_SEARCH_WIDTH, BENCH_SEARCH_HEIGHT);
+        game_set_seed(game, BENCH_SEARCH_SEED);
+        game_change_level(game, 1);
+
+        // Count the second pass: a death in the first may still grow the arena once
+        int restarts = 0;
+        long heap_calls = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            long before = __atomic_load_n(&bench_heap_calls, __ATOMIC_RELAXED);
+            for (int tick = 0; tick < BENCH_HEAP_TICKS; tick++) {
+                if (game_tick(game)) {
+                    game_change_level(game, 1);
+                    restarts++;
+                }
+            }
+            heap_calls = __atomic_load_n(&bench_heap_calls, __ATOMIC_RELAXED) - before;
+        }
+
+        printf("%-28s %s: %ld heap calls in %d ticks (%d restarts, arena peak %zu of %zu bytes)\n",
+               "heap_calls_per_tick", names[i], heap_calls, BENCH_HEAP_TICKS, restarts,
+               game->arena->peak, game->arena->capacity);
+        if (heap_calls != 0) passed = false;
+
+        game_destroy(game);
+    }
+
+    return passed;
+}
+
+/******************************************************************************
+ * @brief 基准测试入口
+ * 
+ * 在固定尺寸棋盘上对节拍热路径的各个函数分别计时，
+ * 参数化蛇长度（1、100、10k）和棋盘填充率，结果写入 CSV
+ * 
+ * @param argc 参数个数
+ * @param argv 参数数组，argv[1] 为 CSV 输出路径
+ * @return int 退出码 - 0 表示成功，1 表示失败
+ *****************************************************************************/
+int main(int argc, char** argv) {
+    const char* csv_path = argc > 1 ? argv[1] : "bench_results.csv";
+    FILE* csv = fopen(csv_path, "w");
+    if (!csv) {
+        fprintf(stderr, "Cannot open %s\n", csv_path);
+        return 1;
+    }
+    fprintf(csv, "benchmark,snake_length,fill,samples,ops_per_sample,"
+                 "mean_ns,min_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+
+    headless_set_size(BENCH_BOARD_WIDTH + 2, BENCH_BOARD_HEIGHT + 2);
+    ui_set_renderer(get_headless_renderer());
+
+    static const int lengths[] = {1, 100, 10000};
+    static const double fills[] = {0.0, 0.5, 0.9, 0.99};
+    const int interior = (BENCH_BOARD_WIDTH - 2) * (BENCH_BOARD_HEIGHT - 2);
+    bench_result_t result;
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        int length = lengths[i];
+
+        bench_run(&result, "snake_move_normal", length, 1000, bench_op_move);
+        bench_report(&result, csv);
+        bench_run(&result, "snake_check_collision_normal", length, 1000, bench_op_collision);
+        bench_report(&result, csv);
+        bench_run(&result, "snake_contains_point", length, 1000, bench_op_contains);
+        bench_report(&result, csv);
+        bench_run(&result, "autopilot_steer", length, 10, bench_op_autopilot);
+        bench_report(&result, csv);
+        bench_run(&result, "hamilton_steer", length, 1000, bench_op_hamilton);
+        bench_report(&result, csv);
+        bench_run(&result, "distance_field_full", length, 100, bench_op_distance_full);
+        bench_report(&result, csv);
+        bench_run(&result, "distance_field_incremental", length, 1000, bench_op_distance_incremental);
+        bench_report(&result, csv);
+        bench_run(&result, "ui_render_game_screen", length, 100, bench_op_render_incremental);
+        bench_report(&result, csv);
+        bench_run(&result, "ui_render_game_screen_full", length, 10, bench_op_render_full);
+        bench_report(&result, csv);
+    }
+
+    bench_run(&result, "hamilton_create", 1, 1, bench_op_hamilton_create);
+    bench_report(&result, csv);
+
+    bench_run_flood(csv);
+
+    bench_run_search(&result, "mcts_choose_direction", 0, csv);
+    bench_run_search(&result, "mcts_choose_direction_table", BENCH_SEARCH_TABLE_BITS, csv);
+
+    for (size_t i = 0; i < sizeof(fills) / sizeof(fills[0]); i++) {
+        int length = (int)(fills[i] * interior);
+        bench_run(&result, "food_find_valid_position", length, 1000, bench_op_food);
+        bench_report(&result, csv);
+    }
+
+    bool heap_ok = bench_run_heap_check();
+
+    fclose(csv);
+    printf("Results written to %s\n", csv_path);
+    if (!heap_ok) {
+        fprintf(stderr, "Heap calls on the tick path, see heap_calls_per_tick above\n");
+        return 1;
+    }
+    return 0;
+}
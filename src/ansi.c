@@ -0,0 +1,453 @@
+#define _POSIX_C_SOURCE 200809L
+#include "ansi.h"
+#include "input.h"
+#include "utils.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Terminal modes: alternate screen, hidden cursor, no autowrap
+#define ANSI_ENTER      "\x1b[?1049h\x1b[?25l\x1b[?7l"
+#define ANSI_LEAVE      "\x1b[0m\x1b[?7h\x1b[?25h\x1b[?1049l"
+#define ANSI_CLEAR      "\x1b[0m\x1b[2J"
+
+// Unknown cursor coordinate or colour pair
+#define ANSI_UNKNOWN    -1
+
+// SGR sequence of each colour pair (see utils.h), pair 0 is the default
+static const char* ansi_colors[] = {
+    "\x1b[39;49m",
+    "\x1b[32;40m",  // COLOR_SNAKE: green on black
+    "\x1b[31;40m",  // COLOR_FOOD: red on black
+    "\x1b[37;40m",  // COLOR_WALL: white on black
+    "\x1b[36;40m",  // COLOR_UI: cyan on black
+    "\x1b[33;40m"   // COLOR_HIGHLIGHT: yellow on black
+};
+
+#define ANSI_COLOR_COUNT ((int)(sizeof(ansi_colors) / sizeof(ansi_colors[0])))
+
+// Renderer state. cursor and color describe the terminal after every byte
+// already in the buffer has been written
+static struct {
+    char* buffer;
+    size_t capacity;
+    size_t length;
+    int width;
+    int height;
+    int cursor_x;
+    int cursor_y;
+    int color;
+    unsigned char input[64];    // Bytes read from stdin, not yet decoded
+    int input_length;
+    int input_pos;
+    struct termios saved;
+    bool active;
+} ansi;
+
+// Set by SIGWINCH, the size is queried again on the next get_size
+static volatile sig_atomic_t ansi_resized;
+
+static struct sigaction ansi_saved_winch;
+static struct sigaction ansi_saved_int;
+static struct sigaction ansi_saved_term;
+
+// Renderer entry points
+static void ansi_init(void);
+static void ansi_cleanup(void);
+static void ansi_clear_screen(void);
+static void ansi_draw_border(int width, int height, int offset_x, int offset_y);
+static void ansi_draw_text(int x, int y, const char* text, int color_pair);
+static void ansi_draw_char(int x, int y, char ch, int color_pair);
+static void ansi_get_size(int* width, int* height);
+static void ansi_refresh(void);
+static int ansi_read_key(void);
+
+// Static renderer instance
+static renderer_t ansi_renderer = {
+    .init = ansi_init,
+    .cleanup = ansi_cleanup,
+    .clear_screen = ansi_clear_screen,
+    .draw_border = ansi_draw_border,
+    .draw_text = ansi_draw_text,
+    .draw_char = ansi_draw_char,
+    .get_size = ansi_get_size,
+    .refresh = ansi_refresh,
+    .read_key = ansi_read_key
+};
+
+/******************************************************************************
+ * @brief 把一段字节完整写到标准输出
+ * 
+ * 被信号中断时重试，其他错误时丢弃剩余字节
+ *****************************************************************************/
+static void ansi_write_all(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+}
+
+/******************************************************************************
+ * @brief 把帧缓冲区写到终端并清空
+ *****************************************************************************/
+static void ansi_flush(void) {
+    if (ansi.length == 0) return;
+
+    ansi_write_all(ansi.buffer, ansi.length);
+    ansi.length = 0;
+}
+
+/******************************************************************************
+ * @brief 向帧缓冲区追加字节
+ * 
+ * 缓冲区放不下时先把已有内容写出（一帧多一次 write），
+ * 比缓冲区还长的数据直接写出
+ *****************************************************************************/
+static void ansi_append(const char* data, size_t length) {
+    if (length > ansi.capacity - ansi.length) {
+        ansi_flush();
+        if (length > ansi.capacity) {
+            ansi_write_all(data, length);
+            return;
+        }
+    }
+    memcpy(ansi.buffer + ansi.length, data, length);
+    ansi.length += length;
+}
+
+static inline void ansi_append_string(const char* text) {
+    ansi_append(text, strlen(text));
+}
+
+/******************************************************************************
+ * @brief 追加 CSI 序列：ESC [ 参数 结束符
+ * 
+ * second 为 0 时只有一个参数；单个参数为 1 时省略（默认值）
+ *****************************************************************************/
+static void ansi_append_csi(int first, int second, char final) {
+    char sequence[32];
+    int length = 0;
+    char digits[12];
+
+    sequence[length++] = '\x1b';
+    sequence[length++] = '[';
+    for (int i = 0; i < 2; i++) {
+        int value = i == 0 ? first : second;
+        if (i == 1) {
+            if (second <= 0) break;
+            sequence[length++] = ';';
+        } else if (first == 1 && second <= 0) {
+            continue;
+        }
+
+        int count = 0;
+        while (value > 0) {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        }
+        while (count > 0) {
+            sequence[length++] = digits[--count];
+        }
+    }
+    sequence[length++] = final;
+    ansi_append(sequence, (size_t)length);
+}
+
+/******************************************************************************
+ * @brief 把光标移到指定格子
+ * 
+ * 光标已在该格子时不输出任何字节；同一行或同一列时用相对移动
+ * （CUF/CUB/CUD/CUU），否则用绝对定位（CUP）
+ * 
+ * @param x 列（从 0 开始）
+ * @param y 行（从 0 开始）
+ *****************************************************************************/
+static void ansi_move(int x, int y) {
+    if (x == ansi.cursor_x && y == ansi.cursor_y) return;
+
+    if (y == ansi.cursor_y && ansi.cursor_x != ANSI_UNKNOWN) {
+        int distance = x - ansi.cursor_x;
+        ansi_append_csi(distance > 0 ? distance : -distance, 0, distance > 0 ? 'C' : 'D');
+    } else if (x == ansi.cursor_x && ansi.cursor_y != ANSI_UNKNOWN) {
+        int distance = y - ansi.cursor_y;
+        ansi_append_csi(distance > 0 ? distance : -distance, 0, distance > 0 ? 'B' : 'A');
+    } else {
+        ansi_append_csi(y + 1, x + 1, 'H');
+    }
+    ansi.cursor_x = x;
+    ansi.cursor_y = y;
+}
+
+/******************************************************************************
+ * @brief 切换颜色对，与当前颜色相同时不输出
+ *****************************************************************************/
+static void ansi_set_color(int color_pair) {
+    if (color_pair < 0 || color_pair >= ANSI_COLOR_COUNT) color_pair = 0;
+    if (color_pair == ansi.color) return;
+
+    ansi_append_string(ansi_colors[color_pair]);
+    ansi.color = color_pair;
+}
+
+/******************************************************************************
+ * @brief 在指定位置输出一段同色字符，超出屏幕的部分被裁掉
+ * 
+ * 自动换行已关闭，写到最后一列后光标停在原地，此时记为未知
+ *****************************************************************************/
+static void ansi_put(int x, int y, const char* text, int length, int color_pair) {
+    if (y < 0 || y >= ansi.height || x >= ansi.width) return;
+    if (x < 0) {
+        text -= x;
+        length += x;
+        x = 0;
+    }
+    if (length > ansi.width - x) length = ansi.width - x;
+    if (length <= 0) return;
+
+    ansi_move(x, y);
+    ansi_set_color(color_pair);
+    ansi_append(text, (size_t)length);
+    ansi.cursor_x = x + length < ansi.width ? x + length : ANSI_UNKNOWN;
+}
+
+/******************************************************************************
+ * @brief 恢复终端状态（可在信号处理函数中调用）
+ *****************************************************************************/
+static void ansi_restore_terminal(void) {
+    if (write(STDOUT_FILENO, ANSI_LEAVE, sizeof(ANSI_LEAVE) - 1) < 0) {
+        // Nothing else to try
+    }
+    tcsetattr(STDIN_FILENO, TCSANOW, &ansi.saved);
+}
+
+static void ansi_handle_resize(int signal_number) {
+    (void)signal_number;
+    ansi_resized = 1;
+}
+
+/******************************************************************************
+ * @brief 收到终止信号时恢复终端，再按默认方式处理该信号
+ *****************************************************************************/
+static void ansi_handle_exit(int signal_number) {
+    ansi_restore_terminal();
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+
+/******************************************************************************
+ * @brief 初始化 ANSI 终端
+ * 
+ * 1. 关闭行缓冲和回显，read() 不等待输入
+ * 2. 切换到备用屏幕，隐藏光标，关闭自动换行
+ * 3. 按终端尺寸分配帧缓冲区
+ * 4. 安装 SIGWINCH 和终止信号的处理函数
+ *****************************************************************************/
+static void ansi_init(void) {
+    tcgetattr(STDIN_FILENO, &ansi.saved);
+    struct termios raw = ansi.saved;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+    get_terminal_size(&ansi.width, &ansi.height);
+    ansi_resized = 0;
+
+    size_t capacity = (size_t)ansi.width * ansi.height * ANSI_BYTES_PER_CELL;
+    ansi.capacity = capacity > ANSI_MIN_BUFFER ? capacity : ANSI_MIN_BUFFER;
+    ansi.buffer = malloc(ansi.capacity);
+    if (!ansi.buffer) {
+        // Unbuffered: every append is written through
+        ansi.capacity = 0;
+    }
+    ansi.length = 0;
+    ansi.cursor_x = ANSI_UNKNOWN;
+    ansi.cursor_y = ANSI_UNKNOWN;
+    ansi.color = ANSI_UNKNOWN;
+    ansi.input_length = 0;
+    ansi.input_pos = 0;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = ansi_handle_resize;
+    sigaction(SIGWINCH, &action, &ansi_saved_winch); // No SA_RESTART: wakes the event loop
+    action.sa_handler = ansi_handle_exit;
+    sigaction(SIGINT, &action, &ansi_saved_int);
+    sigaction(SIGTERM, &action, &ansi_saved_term);
+    ansi.active = true;
+
+    ansi_append_string(ANSI_ENTER ANSI_CLEAR);
+    ansi.color = 0;
+    ansi_flush();
+}
+
+/******************************************************************************
+ * @brief 恢复终端并释放帧缓冲区
+ *****************************************************************************/
+static void ansi_cleanup(void) {
+    if (!ansi.active) return;
+
+    ansi_flush();
+    ansi_restore_terminal();
+    sigaction(SIGWINCH, &ansi_saved_winch, NULL);
+    sigaction(SIGINT, &ansi_saved_int, NULL);
+    sigaction(SIGTERM, &ansi_saved_term, NULL);
+
+    free(ansi.buffer);
+    ansi.buffer = NULL;
+    ansi.capacity = 0;
+    ansi.active = false;
+}
+
+/******************************************************************************
+ * @brief 清屏
+ * 
+ * 清屏会覆盖本帧之前的所有绘制，所以先丢弃缓冲区中尚未写出的内容。
+ * 丢弃后不再知道光标位置，下一次绘制使用绝对定位
+ *****************************************************************************/
+static void ansi_clear_screen(void) {
+    ansi.length = 0;
+    ansi_append_string(ANSI_CLEAR);
+    ansi.cursor_x = ANSI_UNKNOWN;
+    ansi.cursor_y = ANSI_UNKNOWN;
+    ansi.color = 0;
+}
+
+/******************************************************************************
+ * @brief 绘制游戏区域边框
+ * 
+ * 与 ncurses 渲染器相同：'=' 为水平边框，'|' 为竖直边框（含四角）。
+ * 上下两行各一次输出，两侧的竖线之间用相对移动
+ * 
+ * @param width 区域宽度
+ * @param height 区域高度
+ * @param offset_x X 偏移量
+ * @param offset_y Y 偏移量
+ *****************************************************************************/
+static void ansi_draw_border(int width, int height, int offset_x, int offset_y) {
+    if (width < 2 || height < 2) return;
+
+    char row[1024];
+    int length = width < (int)sizeof(row) ? width : (int)sizeof(row);
+    memset(row, '=', (size_t)length);
+    row[0] = '|';
+    if (length == width) row[width - 1] = '|';
+
+    ansi_put(offset_x, offset_y, row, length, COLOR_WALL);
+    for (int y = offset_y + 1; y < offset_y + height - 1; y++) {
+        ansi_put(offset_x, y, "|", 1, COLOR_WALL);
+        ansi_put(offset_x + width - 1, y, "|", 1, COLOR_WALL);
+    }
+    ansi_put(offset_x, offset_y + height - 1, row, length, COLOR_WALL);
+}
+
+/******************************************************************************
+ * @brief 在指定位置绘制文本
+ * 
+ * @param x X 坐标
+ * @param y Y 坐标
+ * @param text 要绘制的文本
+ * @param color_pair 颜色对编号，0 表示不使用颜色
+ *****************************************************************************/
+static void ansi_draw_text(int x, int y, const char* text, int color_pair) {
+    if (!text) return;
+    ansi_put(x, y, text, (int)strlen(text), color_pair);
+}
+
+/******************************************************************************
+ * @brief 在指定位置绘制字符
+ * 
+ * @param x X 坐标
+ * @param y Y 坐标
+ * @param ch 要绘制的字符
+ * @param color_pair 颜色对编号
+ *****************************************************************************/
+static void ansi_draw_char(int x, int y, char ch, int color_pair) {
+    ansi_put(x, y, &ch, 1, color_pair);
+}
+
+/******************************************************************************
+ * @brief 获取屏幕尺寸
+ * 
+ * 尺寸在初始化时查询并缓存，只有收到 SIGWINCH 后才重新查询
+ * 
+ * @param width 输出参数 - 屏幕宽度（列数）
+ * @param height 输出参数 - 屏幕高度（行数）
+ *****************************************************************************/
+static void ansi_get_size(int* width, int* height) {
+    if (ansi_resized) {
+        ansi_resized = 0;
+        get_terminal_size(&ansi.width, &ansi.height);
+    }
+    *width = ansi.width;
+    *height = ansi.height;
+}
+
+/******************************************************************************
+ * @brief 刷新屏幕：一次 write 写出整帧，没有内容时不做系统调用
+ *****************************************************************************/
+static void ansi_refresh(void) {
+    ansi_flush();
+}
+
+/******************************************************************************
+ * @brief 读取下一个按键
+ * 
+ * 缓冲区读空时才调用 read()。方向键的转义序列（ESC [ A 或 ESC O A，
+ * 可带数字参数）转换为 ncurses 的 KEY_UP 等键值，单独的 ESC 即为
+ * KEY_ESC，无法识别的序列被跳过
+ * 
+ * @return int 按键值，无输入返回 ERR
+ *****************************************************************************/
+static int ansi_read_key(void) {
+    for (;;) {
+        if (ansi.input_pos >= ansi.input_length) {
+            ssize_t count = read(STDIN_FILENO, ansi.input, sizeof(ansi.input));
+            if (count <= 0) return ERR;
+            ansi.input_length = (int)count;
+            ansi.input_pos = 0;
+        }
+
+        int key = ansi.input[ansi.input_pos++];
+        if (key != KEY_ESC) return key;
+
+        // A lone escape byte is the Escape key
+        if (ansi.input_pos >= ansi.input_length) return KEY_ESC;
+        int introducer = ansi.input[ansi.input_pos];
+        if (introducer != '[' && introducer != 'O') return KEY_ESC;
+        ansi.input_pos++;
+
+        // Skip parameter and intermediate bytes up to the final byte
+        while (ansi.input_pos < ansi.input_length &&
+               ansi.input[ansi.input_pos] >= 0x20 && ansi.input[ansi.input_pos] < 0x40) {
+            ansi.input_pos++;
+        }
+        if (ansi.input_pos >= ansi.input_length) return KEY_ESC;
+
+        switch (ansi.input[ansi.input_pos++]) {
+            case 'A': return KEY_UP;
+            case 'B': return KEY_DOWN;
+            case 'C': return KEY_RIGHT;
+            case 'D': return KEY_LEFT;
+            default:  break; // Not a key the game uses
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 获取 ANSI 终端渲染器实例
+ * 
+ * @return renderer_t* ANSI 终端渲染器指针
+ *****************************************************************************/
+renderer_t* get_ansi_renderer(void) {
+    return &ansi_renderer;
+}
@@ -0,0 +1,21 @@
+#ifndef ANSI_H
+#define ANSI_H
+
+#include "game.h"
+
+// Smallest frame buffer, grown with the terminal size at init
+#define ANSI_MIN_BUFFER         65536
+
+// Frame buffer bytes per screen cell: a full redraw of a cell needs at
+// most a colour change and the character, cursor moves are shared
+#define ANSI_BYTES_PER_CELL     12
+
+// Raw ANSI terminal renderer. Every drawing call appends escape sequences
+// to one preallocated frame buffer and refresh flushes it with a single
+// write(2). The renderer tracks the terminal's cursor and colour, so it
+// only moves the cursor when the next cell is not where the last one left
+// it, and only changes the colour when it differs. Keys are read straight
+// from stdin and decoded to the ncurses key codes the input handlers use.
+renderer_t* get_ansi_renderer(void);
+
+#endif // ANSI_H
@@ -0,0 +1,175 @@
+#define _POSIX_C_SOURCE 200809L
+#include "arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Overflow block, the memory follows the header
+struct arena_block {
+    arena_block_t* next;
+    size_t size;
+} __attribute__((aligned(ARENA_ALIGNMENT)));
+
+/******************************************************************************
+ * @brief 把大小向上取整到分配对齐
+ *****************************************************************************/
+static inline size_t arena_align(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/******************************************************************************
+ * @brief 创建内存池
+ * 
+ * @param capacity 主内存块字节数
+ * @return arena_t* 内存池指针，失败返回 NULL
+ *****************************************************************************/
+arena_t* arena_create(size_t capacity) {
+    arena_t* arena = calloc(1, sizeof(arena_t));
+    if (!arena) return NULL;
+
+    if (!arena_reserve(arena, capacity)) {
+        free(arena);
+        return NULL;
+    }
+    return arena;
+}
+
+/******************************************************************************
+ * @brief 释放所有溢出内存块
+ *****************************************************************************/
+static void arena_free_overflow(arena_t* arena) {
+    arena_block_t* block = arena->overflow;
+    while (block) {
+        arena_block_t* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->overflow = NULL;
+    arena->overflow_bytes = 0;
+}
+
+/******************************************************************************
+ * @brief 销毁内存池及其中的所有分配
+ * 
+ * @param arena 内存池指针
+ *****************************************************************************/
+void arena_destroy(arena_t* arena) {
+    if (!arena) return;
+
+    arena_free_overflow(arena);
+    free(arena->base);
+    free(arena);
+}
+
+/******************************************************************************
+ * @brief 确保主内存块至少有指定容量
+ * 
+ * 只能在内存池为空（刚创建或刚重置）时调用，容量足够时不做任何事
+ * 
+ * @param arena 内存池指针
+ * @param capacity 所需字节数
+ * @return bool 成功返回 true，分配失败返回 false（原内存块保持不变）
+ *****************************************************************************/
+bool arena_reserve(arena_t* arena, size_t capacity) {
+    if (!arena) return false;
+
+    capacity = arena_align(capacity);
+    if (capacity <= arena->capacity) return true;
+
+    void* base = NULL;
+    if (posix_memalign(&base, ARENA_ALIGNMENT, capacity) != 0) return false;
+
+    free(arena->base);
+    arena->base = base;
+    arena->capacity = capacity;
+    arena->used = 0;
+    return true;
+}
+
+/******************************************************************************
+ * @brief 重置内存池，一次释放所有分配
+ * 
+ * 通常只是把偏移量归零。上一轮用到了溢出块时，把主内存块扩大到
+ * 上一轮的总用量，之后同样大小的一轮不会再溢出
+ * 
+ * @param arena 内存池指针
+ *****************************************************************************/
+void arena_reset(arena_t* arena) {
+    if (!arena) return;
+
+    size_t needed = arena->used + arena->overflow_bytes;
+    arena->used = 0;
+    if (arena->overflow) {
+        arena_free_overflow(arena);
+        arena_reserve(arena, needed); // On failure the overflow path still works
+    }
+}
+
+/******************************************************************************
+ * @brief 从内存池分配内存
+ * 
+ * 主内存块不够时分配一个溢出块。内存池为 NULL 时直接调用 malloc
+ * 
+ * @param arena 内存池指针，可为 NULL
+ * @param size 字节数
+ * @return void* 按 ARENA_ALIGNMENT 对齐的内存，失败返回 NULL
+ *****************************************************************************/
+void* arena_alloc(arena_t* arena, size_t size) {
+    if (!arena) return malloc(size);
+
+    size = arena_align(size ? size : 1);
+    void* ptr;
+    if (size <= arena->capacity - arena->used) {
+        ptr = arena->base + arena->used;
+        arena->used += size;
+    } else {
+        arena_block_t* block = NULL;
+        if (posix_memalign((void**)&block, ARENA_ALIGNMENT, sizeof(arena_block_t) + size) != 0) {
+            return NULL;
+        }
+        block->next = arena->overflow;
+        block->size = size;
+        arena->overflow = block;
+        arena->overflow_bytes += size;
+        ptr = block + 1;
+    }
+
+    if (arena->used + arena->overflow_bytes > arena->peak) {
+        arena->peak = arena->used + arena->overflow_bytes;
+    }
+    return ptr;
+}
+
+/******************************************************************************
+ * @brief 从内存池分配清零的数组
+ * 
+ * @param arena 内存池指针，可为 NULL（直接调用 calloc）
+ * @param count 元素个数
+ * @param size 元素字节数
+ * @return void* 清零的内存，溢出或失败返回 NULL
+ *****************************************************************************/
+void* arena_calloc(arena_t* arena, size_t count, size_t size) {
+    if (!arena) return calloc(count, size);
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+
+    void* ptr = arena_alloc(arena, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/******************************************************************************
+ * @brief 释放内存
+ * 
+ * 内存池中的分配不单独释放，等 arena_reset 统一回收；
+ * 内存池为 NULL 时直接调用 free
+ * 
+ * @param arena 内存池指针，可为 NULL
+ * @param ptr 内存指针
+ *****************************************************************************/
+void arena_free(arena_t* arena, void* ptr) {
+    if (!arena) {
+        free(ptr);
+    }
+}
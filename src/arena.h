@@ -0,0 +1,41 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Alignment of every arena allocation
+#define ARENA_ALIGNMENT 16
+
+typedef struct arena arena_t;
+typedef struct arena_block arena_block_t;
+
+// Bump allocator for memory that lives exactly as long as one game.
+// Allocations are never freed one by one; arena_reset releases all of
+// them at once by rewinding the offset. Requests that do not fit the main
+// block go to overflow blocks, and the next reset folds the overflow into
+// one larger main block, so a steady-state reset is a plain rewind.
+//
+// Every allocation function takes a NULL arena to mean the C heap, so
+// the same create/destroy code serves arena and heap objects.
+struct arena {
+    unsigned char* base;    // Main block
+    size_t capacity;
+    size_t used;
+    arena_block_t* overflow; // Blocks allocated after the main block ran out
+    size_t overflow_bytes;  // Bytes handed out from overflow blocks
+    size_t peak;            // Most bytes in use before any reset
+};
+
+// Arena management
+arena_t* arena_create(size_t capacity);
+void arena_destroy(arena_t* arena);
+void arena_reset(arena_t* arena);
+bool arena_reserve(arena_t* arena, size_t capacity);
+
+// Allocation, NULL arena falls back to malloc/calloc/free
+void* arena_alloc(arena_t* arena, size_t size);
+void* arena_calloc(arena_t* arena, size_t count, size_t size);
+void arena_free(arena_t* arena, void* ptr);
+
+#endif // ARENA_H
@@ -0,0 +1,381 @@
+#include "autopilot.h"
+#include "snake.h"
+#include "food.h"
+#include "grid.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void autopilot_reset(game_t* game);
+static void autopilot_steer(game_t* game);
+
+// Static controller instance
+static controller_t autopilot_controller = {
+    .name = "Autopilot",
+    .reset = autopilot_reset,
+    .steer = autopilot_steer
+};
+
+/******************************************************************************
+ * @brief 创建自动驾驶搜索缓冲区
+ * 
+ * 所有数组按棋盘格子数一次性分配，之后每个节拍的搜索都不再分配内存
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param arena 内存池，NULL 表示从堆上分配
+ * @return autopilot_t* 缓冲区指针，失败返回 NULL
+ *****************************************************************************/
+autopilot_t* autopilot_create(int width, int height, arena_t* arena) {
+    if (width < 3 || height < 3) return NULL;
+
+    autopilot_t* autopilot = arena_calloc(arena, 1, sizeof(autopilot_t));
+    if (!autopilot) return NULL;
+
+    size_t count = (size_t)width * height;
+    autopilot->arena = arena;
+    autopilot->width = width;
+    autopilot->height = height;
+    autopilot->cell_count = (int)count;
+
+    autopilot->visited = arena_calloc(arena, count, sizeof(uint32_t));
+    autopilot->parent = arena_alloc(arena, sizeof(int) * count);
+    autopilot->distance = arena_alloc(arena, sizeof(int) * count);
+    autopilot->queue = arena_alloc(arena, sizeof(int) * count);
+    autopilot->blocked = arena_calloc(arena, count, sizeof(uint32_t));
+    autopilot->free_at = arena_alloc(arena, sizeof(int) * count);
+    autopilot->path = arena_alloc(arena, sizeof(int) * count);
+    autopilot->body = arena_alloc(arena, sizeof(int) * count);
+    autopilot->virtual_body = arena_alloc(arena, sizeof(int) * count);
+
+    if (!autopilot->visited || !autopilot->parent || !autopilot->distance ||
+        !autopilot->queue || !autopilot->blocked || !autopilot->free_at ||
+        !autopilot->path || !autopilot->body || !autopilot->virtual_body) {
+        autopilot_destroy(autopilot);
+        return NULL;
+    }
+
+    return autopilot;
+}
+
+/******************************************************************************
+ * @brief 销毁自动驾驶搜索缓冲区
+ * 
+ * @param autopilot 缓冲区指针
+ *****************************************************************************/
+void autopilot_destroy(autopilot_t* autopilot) {
+    if (!autopilot) return;
+
+    arena_free(autopilot->arena, autopilot->visited);
+    arena_free(autopilot->arena, autopilot->parent);
+    arena_free(autopilot->arena, autopilot->distance);
+    arena_free(autopilot->arena, autopilot->queue);
+    arena_free(autopilot->arena, autopilot->blocked);
+    arena_free(autopilot->arena, autopilot->free_at);
+    arena_free(autopilot->arena, autopilot->path);
+    arena_free(autopilot->arena, autopilot->body);
+    arena_free(autopilot->arena, autopilot->virtual_body);
+    arena_free(autopilot->arena, autopilot);
+}
+
+/******************************************************************************
+ * @brief 递增代数，使所有旧标记失效
+ * 
+ * 计数器回绕到 0 时清空标记数组，保证旧标记不会被误认
+ * 
+ * @param generation 代数计数器
+ * @param stamps 标记数组
+ * @param count 数组长度
+ *****************************************************************************/
+static void autopilot_next_generation(uint32_t* generation, uint32_t* stamps, int count) {
+    if (++*generation == 0) {
+        memset(stamps, 0, sizeof(uint32_t) * count);
+        *generation = 1;
+    }
+}
+
+/******************************************************************************
+ * @brief 将蛇身标记为阻挡
+ * 
+ * 第 i 段在 length - i + extra 步之后离开棋盘
+ * 
+ * @param autopilot 缓冲区指针
+ * @param body 蛇身格子，头部在前
+ * @param length 蛇长度
+ * @param extra 额外的生长步数
+ *****************************************************************************/
+static void autopilot_block_body(autopilot_t* autopilot, const int* body, int length, int extra) {
+    autopilot_next_generation(&autopilot->block_generation, autopilot->blocked,
+                              autopilot->cell_count);
+
+    for (int i = 0; i < length; i++) {
+        autopilot->blocked[body[i]] = autopilot->block_generation;
+        autopilot->free_at[body[i]] = length - i + extra;
+    }
+}
+
+/******************************************************************************
+ * @brief 从起点开始广度优先搜索
+ * 
+ * 只经过内部格子；被阻挡的格子只有在到达时已经空出才能通过。
+ * target 为 -1 时搜索所有可达格子
+ * 
+ * @param autopilot 缓冲区指针
+ * @param start 起点格子
+ * @param start_distance 起点距离当前的步数
+ * @param target 目标格子，-1 表示没有目标
+ * @param avoid 不允许从起点直接进入的格子，-1 表示没有
+ * @return int 搜索到的格子数
+ *****************************************************************************/
+static int autopilot_search(autopilot_t* autopilot, int start, int start_distance,
+                            int target, int avoid) {
+    const int width = autopilot->width;
+    const int height = autopilot->height;
+    const uint32_t block_generation = autopilot->block_generation;
+
+    autopilot_next_generation(&autopilot->search_generation, autopilot->visited,
+                              autopilot->cell_count);
+    const uint32_t generation = autopilot->search_generation;
+
+    int head = 0;
+    int tail = 0;
+    autopilot->queue[tail++] = start;
+    autopilot->visited[start] = generation;
+    autopilot->parent[start] = -1;
+    autopilot->distance[start] = start_distance;
+
+    while (head < tail) {
+        int cell = autopilot->queue[head++];
+        if (cell == target) break;
+
+        int x = cell % width;
+        int y = cell / width;
+        int next_distance = autopilot->distance[cell] + 1;
+
+        int neighbors[4];
+        int count = 0;
+        if (y > 1) neighbors[count++] = cell - width;
+        if (y < height - 2) neighbors[count++] = cell + width;
+        if (x > 1) neighbors[count++] = cell - 1;
+        if (x < width - 2) neighbors[count++] = cell + 1;
+
+        for (int i = 0; i < count; i++) {
+            int next = neighbors[i];
+            if (autopilot->visited[next] == generation) continue;
+            if (cell == start && next == avoid) continue;
+            if (autopilot->blocked[next] == block_generation &&
+                next_distance < autopilot->free_at[next]) continue;
+
+            autopilot->visited[next] = generation;
+            autopilot->parent[next] = cell;
+            autopilot->distance[next] = next_distance;
+            autopilot->queue[tail++] = next;
+        }
+    }
+
+    return head;
+}
+
+/******************************************************************************
+ * @brief 检查上一次搜索是否到达了格子
+ * 
+ * @param autopilot 缓冲区指针
+ * @param cell 格子
+ * @return bool 到达返回 true
+ *****************************************************************************/
+static bool autopilot_reached(autopilot_t* autopilot, int cell) {
+    return autopilot->visited[cell] == autopilot->search_generation;
+}
+
+/******************************************************************************
+ * @brief 沿父节点回溯出到目标的路径
+ * 
+ * @param autopilot 缓冲区指针
+ * @param target 目标格子（必须已被上一次搜索到达）
+ *****************************************************************************/
+static void autopilot_trace_path(autopilot_t* autopilot, int target) {
+    autopilot->path_length = 0;
+    for (int cell = target; autopilot->parent[cell] != -1; cell = autopilot->parent[cell]) {
+        autopilot->path[autopilot->path_length++] = cell;
+    }
+}
+
+/******************************************************************************
+ * @brief 计算从一个格子走到相邻格子的方向
+ * 
+ * @param autopilot 缓冲区指针
+ * @param from 起点格子
+ * @param to 相邻格子
+ * @return direction_t 移动方向
+ *****************************************************************************/
+static direction_t autopilot_direction_between(autopilot_t* autopilot, int from, int to) {
+    int delta = to - from;
+    if (delta == -autopilot->width) return DIR_UP;
+    if (delta == autopilot->width) return DIR_DOWN;
+    if (delta == -1) return DIR_LEFT;
+    return DIR_RIGHT;
+}
+
+/******************************************************************************
+ * @brief 检查沿当前路径吃到食物后是否还能走到蛇尾
+ * 
+ * 构造走完路径后的虚拟蛇（吃到食物后还会生长一格），
+ * 能从新的头部走到新的尾部说明不会把自己困死
+ * 
+ * @param autopilot 缓冲区指针
+ * @param length 当前蛇长度（包含待生长的一格）
+ * @return bool 安全返回 true
+ *****************************************************************************/
+static bool autopilot_path_is_safe(autopilot_t* autopilot, int length) {
+    int count = 0;
+
+    for (int i = 0; i < autopilot->path_length && count < length; i++) {
+        autopilot->virtual_body[count++] = autopilot->path[i];
+    }
+    for (int i = 0; count < length; i++) {
+        autopilot->virtual_body[count++] = autopilot->body[i];
+    }
+
+    if (count < 2) return true;
+
+    autopilot_block_body(autopilot, autopilot->virtual_body, count, 1);
+    int tail = autopilot->virtual_body[count - 1];
+    autopilot_search(autopilot, autopilot->virtual_body[0], 0, tail, -1);
+
+    return autopilot_reached(autopilot, tail);
+}
+
+/******************************************************************************
+ * @brief 为下一个节拍选择方向
+ * 
+ * 依次尝试：
+ * 1. 到食物的最短路径，且吃到后还能走到蛇尾
+ * 2. 绕远路追着蛇尾走，保持存活，直到出现安全的路径
+ * 3. 走向可达空间最大的相邻格子
+ * 
+ * @param autopilot 缓冲区指针（尺寸必须与棋盘一致）
+ * @param game 游戏实例指针
+ * @param dir 输出方向
+ * @return bool 找到可走的方向返回 true，无路可走返回 false
+ *****************************************************************************/
+bool autopilot_choose_direction(autopilot_t* autopilot, game_t* game, direction_t* dir) {
+    if (!autopilot || !game || !game->snake || !game->grid || !dir) return false;
+
+    snake_t* snake = game->snake;
+    int length = snake->length;
+    int extra = snake->should_grow ? 1 : 0;
+
+    for (int i = 0; i < length; i++) {
+        autopilot->body[i] = grid_cell_index(game->grid, snake_get_segment(snake, i));
+    }
+
+    // The snake cannot reverse, whatever its length: a turn back is dropped
+    // and the snake carries straight on
+    int head = autopilot->body[0];
+    point_t back = direction_to_point(opposite_direction(snake->direction));
+    int avoid = head + back.y * autopilot->width + back.x;
+
+    // Shortest path to the food that leaves a way back to the tail
+    autopilot_block_body(autopilot, autopilot->body, length, extra);
+    if (game->food && game->food->active) {
+        int food = grid_cell_index(game->grid, game->food->position);
+        autopilot_search(autopilot, head, 0, food, avoid);
+
+        if (food >= 0 && autopilot_reached(autopilot, food)) {
+            autopilot_trace_path(autopilot, food);
+            int first = autopilot->path[autopilot->path_length - 1];
+
+            if (autopilot_path_is_safe(autopilot, length + extra)) {
+                *dir = autopilot_direction_between(autopilot, head, first);
+                return true;
+            }
+            autopilot_block_body(autopilot, autopilot->body, length, extra);
+        }
+    }
+
+    // Otherwise follow the tail the long way round, so the body keeps
+    // shifting until a safe path to the food opens up. With no way back to
+    // the tail, head for the largest open area.
+    int tail = autopilot->body[length - 1];
+    int best_tail_distance = -1;
+    int best_area = 0;
+    bool found = false;
+
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        point_t step = direction_to_point((direction_t)d);
+        int next = head + step.y * autopilot->width + step.x;
+        int x = next % autopilot->width;
+        int y = next / autopilot->width;
+
+        if (next == avoid || x < 1 || x > autopilot->width - 2 ||
+            y < 1 || y > autopilot->height - 2) continue;
+        if (autopilot->blocked[next] == autopilot->block_generation &&
+            autopilot->free_at[next] > 1) continue;
+
+        int area = autopilot_search(autopilot, next, 1, -1, -1);
+        int tail_distance = length > 1 && autopilot_reached(autopilot, tail) ?
+                            autopilot->distance[tail] : -1;
+
+        if (tail_distance > best_tail_distance ||
+            (tail_distance == best_tail_distance && area > best_area)) {
+            best_tail_distance = tail_distance;
+            best_area = area;
+            *dir = (direction_t)d;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+/******************************************************************************
+ * @brief 新一局开始时从本局内存池分配搜索缓冲区
+ * 
+ * 其他控制器在自己的 reset 中也调用它，因为它们会把无法决策的节拍
+ * 交给自动驾驶
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void autopilot_reset(game_t* game) {
+    if (!game || !game->grid) return;
+
+    autopilot_t* autopilot = game->autopilot;
+    if (autopilot && autopilot->width == game->grid->width &&
+        autopilot->height == game->grid->height) {
+        return;
+    }
+
+    autopilot_destroy(autopilot);
+    game->autopilot = autopilot_create(game->grid->width, game->grid->height, game->arena);
+}
+
+/******************************************************************************
+ * @brief 自动驾驶控制器：每个节拍前选择方向
+ * 
+ * 缓冲区通常已在 reset 中分配，没有时在此补上
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void autopilot_steer(game_t* game) {
+    if (!game || !game->snake || !game->grid) return;
+
+    if (!game->autopilot) {
+        autopilot_reset(game);
+    }
+    autopilot_t* autopilot = game->autopilot;
+    if (!autopilot) return;
+
+    direction_t dir;
+    if (autopilot_choose_direction(autopilot, game, &dir)) {
+        snake_clear_turns(game->snake);
+        snake_set_direction(game->snake, dir);
+    }
+}
+
+/******************************************************************************
+ * @brief 获取自动驾驶控制器
+ * 
+ * @return controller_t* 控制器指针
+ *****************************************************************************/
+controller_t* get_autopilot_controller(void) {
+    return &autopilot_controller;
+}
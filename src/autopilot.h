@@ -0,0 +1,50 @@
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+#include "game.h"
+#include "utils.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Breadth-first search buffers for the autopilot, sized to the board and
+// reused every tick. Cells use the occupancy grid's indices. A cell is
+// marked by storing the current generation in its stamp, so starting a new
+// search or a new set of blocked cells is a counter increment, not a clear.
+//
+// Blocked cells carry the number of moves after which they become free:
+// body segment i of a snake of length L leaves the board after L - i moves,
+// so the search can walk into cells the tail will have vacated by then.
+struct autopilot {
+    int width;
+    int height;
+    int cell_count;
+
+    uint32_t search_generation;
+    uint32_t* visited;      // Search stamp per cell
+    int* parent;            // Previous cell on the shortest path
+    int* distance;          // Moves from the search start
+    int* queue;
+
+    uint32_t block_generation;
+    uint32_t* blocked;      // Block stamp per cell
+    int* free_at;           // Moves until a blocked cell is vacated
+
+    int* path;              // Last path found, target first, start excluded
+    int path_length;
+    int* body;              // Snake cells, head first
+    int* virtual_body;      // Snake after following the path, head first
+    arena_t* arena;         // Owner of the memory, NULL for the heap
+};
+
+// Autopilot buffers
+autopilot_t* autopilot_create(int width, int height, arena_t* arena);
+void autopilot_destroy(autopilot_t* autopilot);
+
+// Path search
+bool autopilot_choose_direction(autopilot_t* autopilot, game_t* game, direction_t* dir);
+
+// Controller steering the snake with the autopilot
+controller_t* get_autopilot_controller(void);
+
+#endif // AUTOPILOT_H
@@ -0,0 +1,466 @@
+#include "bitboard.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define BITBOARD_HAVE_SSE2 1
+#endif
+
+// AVX2 code is compiled with a target attribute and only run when the CPU
+// reports support, so the default build still runs on any x86-64
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BITBOARD_HAVE_AVX2 1
+#define BITBOARD_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+// Updates one row of the reach bits, returns true when it changed
+typedef bool (*bitboard_row_fn)(uint64_t* reach, const uint64_t* blocked, int words);
+
+/******************************************************************************
+ * @brief 创建位棋盘
+ * 
+ * 每行按 64 位字对齐，上下各留一行守卫行
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param arena 内存池，NULL 表示从堆上分配
+ * @return bitboard_t* 位棋盘指针，失败返回 NULL
+ *****************************************************************************/
+bitboard_t* bitboard_create(int width, int height, arena_t* arena) {
+    if (width < 1 || height < 1) return NULL;
+
+    bitboard_t* board = arena_alloc(arena, sizeof(bitboard_t));
+    if (!board) return NULL;
+
+    board->arena = arena;
+    board->width = width;
+    board->height = height;
+    board->words_per_row = (width + 63) / 64;
+    board->word_count = board->words_per_row * height;
+    board->kernel = bitboard_best_kernel();
+
+    size_t total = (size_t)board->words_per_row * (height + 2);
+    board->blocked = arena_alloc(arena, sizeof(uint64_t) * total);
+    board->reach = arena_calloc(arena, total, sizeof(uint64_t));
+    if (!board->blocked || !board->reach) {
+        bitboard_destroy(board);
+        return NULL;
+    }
+
+    bitboard_clear(board);
+    return board;
+}
+
+/******************************************************************************
+ * @brief 销毁位棋盘
+ * 
+ * @param board 位棋盘指针
+ *****************************************************************************/
+void bitboard_destroy(bitboard_t* board) {
+    if (!board) return;
+
+    arena_free(board->arena, board->blocked);
+    arena_free(board->arena, board->reach);
+    arena_free(board->arena, board);
+}
+
+/******************************************************************************
+ * @brief 清空位棋盘，只保留边框
+ * 
+ * 边框与 game_is_point_on_border 一致：第一行、最后一行、第一列和最后一列。
+ * 守卫行和每行末尾的填充位同样标记为阻挡
+ * 
+ * @param board 位棋盘指针
+ *****************************************************************************/
+void bitboard_clear(bitboard_t* board) {
+    if (!board) return;
+
+    int words = board->words_per_row;
+    int padding = board->width & 63;
+    uint64_t last_word = padding ? ~UINT64_C(0) << padding : 0;
+
+    memset(board->blocked, 0xff, sizeof(uint64_t) * words * (board->height + 2));
+    for (int y = 1; y < board->height - 1; y++) {
+        uint64_t* row = bitboard_word(board->blocked, board, 0, y);
+        memset(row, 0, sizeof(uint64_t) * words);
+        row[words - 1] = last_word;
+        bitboard_set(board, 0, y);
+        bitboard_set(board, board->width - 1, y);
+    }
+}
+
+/******************************************************************************
+ * @brief 选择当前 CPU 上最快的泛洪填充实现
+ * 
+ * @return bitboard_kernel_t 实现类型
+ *****************************************************************************/
+bitboard_kernel_t bitboard_best_kernel(void) {
+#ifdef BITBOARD_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return BITBOARD_KERNEL_AVX2;
+    }
+#endif
+#ifdef BITBOARD_HAVE_SSE2
+    return BITBOARD_KERNEL_SSE2;
+#else
+    return BITBOARD_KERNEL_SCALAR;
+#endif
+}
+
+/******************************************************************************
+ * @brief 获取泛洪填充实现的名称
+ * 
+ * @param kernel 实现类型
+ * @return const char* 名称
+ *****************************************************************************/
+const char* bitboard_kernel_name(bitboard_kernel_t kernel) {
+    switch (kernel) {
+        case BITBOARD_KERNEL_AVX2: return "avx2";
+        case BITBOARD_KERNEL_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+/******************************************************************************
+ * @brief 在一个字内沿空闲格子向两侧填充
+ * 
+ * 向高位：种子加上空闲掩码时进位会沿连续的空闲位传播，异或后即得填充范围；
+ * 向低位：Kogge-Stone 阻挡填充，6 步覆盖 64 位
+ * 
+ * @param seed 种子位（必须是 open 的子集）
+ * @param open 空闲位
+ * @return uint64_t 种子所在空闲段的全部位
+ *****************************************************************************/
+static inline uint64_t bitboard_fill_word(uint64_t seed, uint64_t open) {
+    uint64_t up = ((open + seed) ^ open) & open;
+
+    uint64_t gen = seed;
+    uint64_t pro = open;
+    gen |= pro & (gen >> 1);  pro &= pro >> 1;
+    gen |= pro & (gen >> 2);  pro &= pro >> 2;
+    gen |= pro & (gen >> 4);  pro &= pro >> 4;
+    gen |= pro & (gen >> 8);  pro &= pro >> 8;
+    gen |= pro & (gen >> 16); pro &= pro >> 16;
+    gen |= pro & (gen >> 32);
+
+    return up | gen;
+}
+
+/******************************************************************************
+ * @brief 更新一个字的可达位
+ * 
+ * 先向上下左右扩张一格（跨字的左右邻居取相邻字的边界位），
+ * 与空闲位相与后再在字内填满所在的空闲段
+ * 
+ * @param reach 本行可达位
+ * @param blocked 本行阻挡位
+ * @param i 字在行内的序号
+ * @param words 每行字数
+ * @return uint64_t 新增的可达位
+ *****************************************************************************/
+static inline uint64_t bitboard_update_word(uint64_t* reach, const uint64_t* blocked,
+                                            int i, int words) {
+    uint64_t c = reach[i];
+    uint64_t grow = c | (c << 1) | (c >> 1) |
+                    (reach[i - 1] >> 63) | (reach[i + 1] << 63) |
+                    reach[i - words] | reach[i + words];
+    uint64_t open = ~blocked[i];
+    uint64_t next = bitboard_fill_word(grow & open, open);
+
+    reach[i] = next;
+    return next ^ c;
+}
+
+/******************************************************************************
+ * @brief 逐字更新一行的可达位（标量实现）
+ * 
+ * @param reach 本行可达位
+ * @param blocked 本行阻挡位
+ * @param words 每行字数
+ * @return bool 本行有变化返回 true
+ *****************************************************************************/
+static bool bitboard_row_scalar(uint64_t* reach, const uint64_t* blocked, int words) {
+    uint64_t changed = 0;
+
+    for (int i = 0; i < words; i++) {
+        changed |= bitboard_update_word(reach, blocked, i, words);
+    }
+
+    return changed != 0;
+}
+
+#ifdef BITBOARD_HAVE_SSE2
+#define BITBOARD_FILL_STEP_SSE2(n) \
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_srli_epi64(gen, n))); \
+    pro = _mm_and_si128(pro, _mm_srli_epi64(pro, n))
+
+/******************************************************************************
+ * @brief bitboard_fill_word 的 SSE2 版本，一次处理 2 个字
+ *****************************************************************************/
+static inline __m128i bitboard_fill_sse2(__m128i seed, __m128i open) {
+    __m128i up = _mm_and_si128(_mm_xor_si128(_mm_add_epi64(open, seed), open), open);
+
+    __m128i gen = seed;
+    __m128i pro = open;
+    BITBOARD_FILL_STEP_SSE2(1);
+    BITBOARD_FILL_STEP_SSE2(2);
+    BITBOARD_FILL_STEP_SSE2(4);
+    BITBOARD_FILL_STEP_SSE2(8);
+    BITBOARD_FILL_STEP_SSE2(16);
+    gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_srli_epi64(gen, 32)));
+
+    return _mm_or_si128(up, gen);
+}
+
+/******************************************************************************
+ * @brief 逐字更新一行的可达位（SSE2 实现）
+ * 
+ * 左右相邻字用非对齐加载错位读取，剩余的奇数字交给标量实现
+ * 
+ * @param reach 本行可达位
+ * @param blocked 本行阻挡位
+ * @param words 每行字数
+ * @return bool 本行有变化返回 true
+ *****************************************************************************/
+static bool bitboard_row_sse2(uint64_t* reach, const uint64_t* blocked, int words) {
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m128i changed = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 2 <= words; i += 2) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(reach + i));
+        __m128i left = _mm_loadu_si128((const __m128i*)(reach + i - 1));
+        __m128i right = _mm_loadu_si128((const __m128i*)(reach + i + 1));
+        __m128i up = _mm_loadu_si128((const __m128i*)(reach + i - words));
+        __m128i down = _mm_loadu_si128((const __m128i*)(reach + i + words));
+
+        __m128i grow = _mm_or_si128(c, _mm_or_si128(_mm_slli_epi64(c, 1), _mm_srli_epi64(c, 1)));
+        grow = _mm_or_si128(grow, _mm_or_si128(_mm_srli_epi64(left, 63), _mm_slli_epi64(right, 63)));
+        grow = _mm_or_si128(grow, _mm_or_si128(up, down));
+
+        __m128i open = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(blocked + i)), ones);
+        __m128i next = bitboard_fill_sse2(_mm_and_si128(grow, open), open);
+
+        changed = _mm_or_si128(changed, _mm_xor_si128(next, c));
+        _mm_storeu_si128((__m128i*)(reach + i), next);
+    }
+
+    uint64_t rest = 0;
+    for (; i < words; i++) {
+        rest |= bitboard_update_word(reach, blocked, i, words);
+    }
+
+    return rest != 0 || _mm_movemask_epi8(_mm_cmpeq_epi32(changed, _mm_setzero_si128())) != 0xffff;
+}
+#endif
+
+#ifdef BITBOARD_HAVE_AVX2
+#define BITBOARD_FILL_STEP_AVX2(n) \
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srli_epi64(gen, n))); \
+    pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, n))
+
+/******************************************************************************
+ * @brief bitboard_fill_word 的 AVX2 版本，一次处理 4 个字
+ *****************************************************************************/
+BITBOARD_AVX2
+static inline __m256i bitboard_fill_avx2(__m256i seed, __m256i open) {
+    __m256i up = _mm256_and_si256(_mm256_xor_si256(_mm256_add_epi64(open, seed), open), open);
+
+    __m256i gen = seed;
+    __m256i pro = open;
+    BITBOARD_FILL_STEP_AVX2(1);
+    BITBOARD_FILL_STEP_AVX2(2);
+    BITBOARD_FILL_STEP_AVX2(4);
+    BITBOARD_FILL_STEP_AVX2(8);
+    BITBOARD_FILL_STEP_AVX2(16);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srli_epi64(gen, 32)));
+
+    return _mm256_or_si256(up, gen);
+}
+
+/******************************************************************************
+ * @brief 逐字更新一行的可达位（AVX2 实现）
+ * 
+ * 与 SSE2 版本相同，每次处理 4 个字，256 列宽的棋盘一行只需一次
+ * 
+ * @param reach 本行可达位
+ * @param blocked 本行阻挡位
+ * @param words 每行字数
+ * @return bool 本行有变化返回 true
+ *****************************************************************************/
+BITBOARD_AVX2
+static bool bitboard_row_avx2(uint64_t* reach, const uint64_t* blocked, int words) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m256i changed = _mm256_setzero_si256();
+    int i = 0;
+
+    for (; i + 4 <= words; i += 4) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(reach + i));
+        __m256i left = _mm256_loadu_si256((const __m256i*)(reach + i - 1));
+        __m256i right = _mm256_loadu_si256((const __m256i*)(reach + i + 1));
+        __m256i up = _mm256_loadu_si256((const __m256i*)(reach + i - words));
+        __m256i down = _mm256_loadu_si256((const __m256i*)(reach + i + words));
+
+        __m256i grow = _mm256_or_si256(c, _mm256_or_si256(_mm256_slli_epi64(c, 1), _mm256_srli_epi64(c, 1)));
+        grow = _mm256_or_si256(grow, _mm256_or_si256(_mm256_srli_epi64(left, 63), _mm256_slli_epi64(right, 63)));
+        grow = _mm256_or_si256(grow, _mm256_or_si256(up, down));
+
+        __m256i open = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(blocked + i)), ones);
+        __m256i next = bitboard_fill_avx2(_mm256_and_si256(grow, open), open);
+
+        changed = _mm256_or_si256(changed, _mm256_xor_si256(next, c));
+        _mm256_storeu_si256((__m256i*)(reach + i), next);
+    }
+
+    uint64_t rest = 0;
+    for (; i < words; i++) {
+        rest |= bitboard_update_word(reach, blocked, i, words);
+    }
+
+    return rest != 0 || !_mm256_testz_si256(changed, changed);
+}
+
+/******************************************************************************
+ * @brief 统计可达位数量（带 popcnt 指令的版本）
+ *****************************************************************************/
+BITBOARD_AVX2
+static int bitboard_count_avx2(const uint64_t* bits, int count) {
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += __builtin_popcountll(bits[i]);
+    }
+    return total;
+}
+#endif
+
+/******************************************************************************
+ * @brief 统计可达位数量
+ * 
+ * @param bits 位数组
+ * @param count 字数
+ * @return int 置位数量
+ *****************************************************************************/
+static int bitboard_count(const uint64_t* bits, int count) {
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += __builtin_popcountll(bits[i]);
+    }
+    return total;
+}
+
+/******************************************************************************
+ * @brief 检查一行中是否还有可达位能跨过字边界扩散到相邻字
+ * 
+ * 向量实现里同一行的各个字并行更新，跨字的进位要到下一次更新才生效
+ * 
+ * @param reach 本行可达位
+ * @param blocked 本行阻挡位
+ * @param words 每行字数
+ * @return bool 还需要再更新一次本行返回 true
+ *****************************************************************************/
+static bool bitboard_row_has_carry(const uint64_t* reach, const uint64_t* blocked, int words) {
+    for (int i = 0; i + 1 < words; i++) {
+        uint64_t right = (reach[i] >> 63) & ~(blocked[i + 1] | reach[i + 1]);
+        uint64_t left = reach[i + 1] & ~((blocked[i] | reach[i]) >> 63);
+        if ((right | left) & 1) return true;
+    }
+    return false;
+}
+
+/******************************************************************************
+ * @brief 按行交替向下、向上扫描，直到某一遍没有任何变化
+ * 
+ * 扫描时直接使用已更新的上一行（或下一行），所以一遍就能把可达区域
+ * 沿扫描方向推进到底；一行变化后先在行内把跨字的进位传完再继续。
+ * 空旷棋盘两遍即收敛，来回折返的通道每折返一次多一遍
+ * 
+ * @param board 位棋盘指针（reach 已写入种子）
+ * @param row 行更新函数
+ *****************************************************************************/
+static void bitboard_sweep(bitboard_t* board, bitboard_row_fn row) {
+    int words = board->words_per_row;
+    bool changed = true;
+
+    for (int pass = 0; changed; pass++) {
+        changed = false;
+        for (int i = 0; i < board->height; i++) {
+            int y = pass % 2 == 0 ? i : board->height - 1 - i;
+            uint64_t* reach = board->reach + (size_t)(y + 1) * words;
+            const uint64_t* blocked = board->blocked + (size_t)(y + 1) * words;
+
+            if (row(reach, blocked, words)) {
+                changed = true;
+                while (bitboard_row_has_carry(reach, blocked, words)) {
+                    row(reach, blocked, words);
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 计算从指定格子出发可以到达的空闲格子
+ * 
+ * 起点本身被占用时（例如蛇头）从它的空闲邻居开始。结果保存在
+ * board->reach 中，可用 bitboard_is_reached 查询
+ * 
+ * @param board 位棋盘指针
+ * @param x 起点 X（相对棋盘左上角）
+ * @param y 起点 Y（相对棋盘左上角）
+ * @return int 可达的空闲格子数量
+ *****************************************************************************/
+int bitboard_flood_fill(bitboard_t* board, int x, int y) {
+    if (!board) return 0;
+
+    int words = board->words_per_row;
+    memset(board->reach + words, 0, sizeof(uint64_t) * board->word_count);
+
+    static const int dx[5] = {0, 0, 0, -1, 1};
+    static const int dy[5] = {0, -1, 1, 0, 0};
+    bool seeded = false;
+
+    for (int i = 0; i < 5; i++) {
+        int cx = x + dx[i];
+        int cy = y + dy[i];
+        if (cx < 0 || cx >= board->width || cy < 0 || cy >= board->height) continue;
+        if (bitboard_test(board, cx, cy)) continue;
+
+        *bitboard_word(board->reach, board, cx, cy) |= UINT64_C(1) << (cx & 63);
+        seeded = true;
+    }
+    if (!seeded) return 0;
+
+    switch (board->kernel) {
+#ifdef BITBOARD_HAVE_AVX2
+        case BITBOARD_KERNEL_AVX2:
+            bitboard_sweep(board, bitboard_row_avx2);
+            return bitboard_count_avx2(board->reach + words, board->word_count);
+#endif
+#ifdef BITBOARD_HAVE_SSE2
+        case BITBOARD_KERNEL_SSE2:
+            bitboard_sweep(board, bitboard_row_sse2);
+            break;
+#endif
+        default:
+            bitboard_sweep(board, bitboard_row_scalar);
+            break;
+    }
+
+    return bitboard_count(board->reach + words, board->word_count);
+}
+
+/******************************************************************************
+ * @brief 检查格子是否被上一次泛洪填充到达
+ * 
+ * @param board 位棋盘指针
+ * @param x 格子 X（相对棋盘左上角）
+ * @param y 格子 Y（相对棋盘左上角）
+ * @return bool 到达返回 true
+ *****************************************************************************/
+bool bitboard_is_reached(const bitboard_t* board, int x, int y) {
+    if (!board || x < 0 || x >= board->width || y < 0 || y >= board->height) return false;
+
+    return (*bitboard_word(board->reach, board, x, y) >> (x & 63)) & 1;
+}
@@ -0,0 +1,66 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "arena.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct bitboard bitboard_t;
+
+// Flood fill implementations. BITBOARD_KERNEL_AVX2 is only picked when the
+// CPU supports it; SSE2 is the x86-64 baseline.
+typedef enum {
+    BITBOARD_KERNEL_SCALAR = 0,
+    BITBOARD_KERNEL_SSE2,
+    BITBOARD_KERNEL_AVX2
+} bitboard_kernel_t;
+
+// Board with one bit per cell, each row packed into whole 64-bit words:
+// cell (x, y) is bit x % 64 of word y * words_per_row + x / 64. Blocked
+// bits cover the walls, the snake body and the padding past the last
+// column, so the free cells are simply the zero bits.
+//
+// Both bit arrays have a guard row above and below the board (all blocked,
+// never reached), so the flood fill kernels read every neighbour word
+// without bounds checks.
+struct bitboard {
+    int width;              // Board width including border
+    int height;             // Board height including border
+    int words_per_row;
+    int word_count;         // Words on the board, guard rows excluded
+    uint64_t* blocked;      // Walls, snake body and row padding
+    uint64_t* reach;        // Cells reached by the last flood fill
+    bitboard_kernel_t kernel;
+    arena_t* arena;         // Owner of the memory, NULL for the heap
+};
+
+// Bitboard management
+bitboard_t* bitboard_create(int width, int height, arena_t* arena);
+void bitboard_destroy(bitboard_t* board);
+void bitboard_clear(bitboard_t* board);
+bitboard_kernel_t bitboard_best_kernel(void);
+const char* bitboard_kernel_name(bitboard_kernel_t kernel);
+
+// Reachability
+int bitboard_flood_fill(bitboard_t* board, int x, int y);
+bool bitboard_is_reached(const bitboard_t* board, int x, int y);
+
+// Bit access, (x, y) relative to the board's top-left corner
+static inline uint64_t* bitboard_word(uint64_t* bits, const bitboard_t* board, int x, int y) {
+    return bits + (size_t)(y + 1) * board->words_per_row + (x >> 6);
+}
+
+static inline void bitboard_set(bitboard_t* board, int x, int y) {
+    *bitboard_word(board->blocked, board, x, y) |= UINT64_C(1) << (x & 63);
+}
+
+static inline void bitboard_reset(bitboard_t* board, int x, int y) {
+    *bitboard_word(board->blocked, board, x, y) &= ~(UINT64_C(1) << (x & 63));
+}
+
+static inline bool bitboard_test(const bitboard_t* board, int x, int y) {
+    return (*bitboard_word(board->blocked, board, x, y) >> (x & 63)) & 1;
+}
+
+#endif // BITBOARD_H
@@ -0,0 +1,327 @@
+#include "distance_field.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define DISTANCE_INFINITE INT32_MAX
+
+/******************************************************************************
+ * @brief 创建距离场
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param arena 内存池，NULL 表示从堆上分配
+ * @return distance_field_t* 距离场指针，失败返回 NULL
+ *****************************************************************************/
+distance_field_t* distance_field_create(int width, int height, arena_t* arena) {
+    if (width < 3 || height < 3) return NULL;
+
+    distance_field_t* field = arena_alloc(arena, sizeof(distance_field_t));
+    if (!field) return NULL;
+
+    int count = width * height;
+    field->arena = arena;
+    field->width = width;
+    field->height = height;
+    field->cell_count = count;
+    field->distance = arena_alloc(arena, sizeof(int32_t) * count);
+    field->blocked = arena_alloc(arena, count);
+    field->queue = arena_alloc(arena, sizeof(int) * count);
+    field->affected = arena_alloc(arena, sizeof(int) * count);
+    field->seeds = arena_alloc(arena, sizeof(uint64_t) * count);
+    field->stamps = arena_calloc(arena, count, sizeof(uint32_t));
+    field->generation = 0;
+    field->full_updates = 0;
+    field->incremental_updates = 0;
+
+    if (!field->distance || !field->blocked || !field->queue ||
+        !field->affected || !field->seeds || !field->stamps) {
+        distance_field_destroy(field);
+        return NULL;
+    }
+
+    distance_field_clear(field);
+    return field;
+}
+
+/******************************************************************************
+ * @brief 销毁距离场
+ * 
+ * @param field 距离场指针
+ *****************************************************************************/
+void distance_field_destroy(distance_field_t* field) {
+    if (!field) return;
+
+    arena_free(field->arena, field->distance);
+    arena_free(field->arena, field->blocked);
+    arena_free(field->arena, field->queue);
+    arena_free(field->arena, field->affected);
+    arena_free(field->arena, field->seeds);
+    arena_free(field->arena, field->stamps);
+    arena_free(field->arena, field);
+}
+
+/******************************************************************************
+ * @brief 清空距离场：只保留边框阻挡，取消目标
+ * 
+ * @param field 距离场指针
+ *****************************************************************************/
+void distance_field_clear(distance_field_t* field) {
+    if (!field) return;
+
+    for (int i = 0; i < field->cell_count; i++) {
+        int x = i % field->width;
+        int y = i / field->width;
+        field->blocked[i] = x == 0 || x == field->width - 1 ||
+                            y == 0 || y == field->height - 1;
+        field->distance[i] = DISTANCE_INFINITE;
+    }
+    field->target = -1;
+    field->stale = false;
+}
+
+/******************************************************************************
+ * @brief 检查下标是否为棋盘内部格子
+ *****************************************************************************/
+static inline bool distance_field_is_interior(const distance_field_t* field, int cell) {
+    int x = cell % field->width;
+    int y = cell / field->width;
+    return cell >= 0 && cell < field->cell_count &&
+           x > 0 && x < field->width - 1 && y > 0 && y < field->height - 1;
+}
+
+/******************************************************************************
+ * @brief 设置目标格子（食物位置）
+ * 
+ * 目标变化时只标记过期，下一次查询时整体重算一次
+ * 
+ * @param field 距离场指针
+ * @param cell 目标格子下标，-1 表示没有目标
+ *****************************************************************************/
+void distance_field_set_target(distance_field_t* field, int cell) {
+    if (!field || cell == field->target) return;
+
+    field->target = cell;
+    field->stale = true;
+}
+
+/******************************************************************************
+ * @brief 从已知距离的格子出发，把更短的距离扩散出去
+ * 
+ * 队列中的格子距离必须单调不减
+ * 
+ * @param field 距离场指针
+ * @param head 队列读位置
+ * @param tail 队列写位置
+ *****************************************************************************/
+static void distance_field_spread(distance_field_t* field, int head, int tail) {
+    const int steps[4] = {-field->width, field->width, -1, 1};
+
+    while (head < tail) {
+        int cell = field->queue[head++];
+        int32_t next_distance = field->distance[cell] + 1;
+
+        for (int d = 0; d < 4; d++) {
+            int next = cell + steps[d];
+            if (field->blocked[next] || field->distance[next] <= next_distance) continue;
+            field->distance[next] = next_distance;
+            field->queue[tail++] = next;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 从目标出发整体重算所有格子的距离（BFS，O(格子数)）
+ * 
+ * @param field 距离场指针
+ *****************************************************************************/
+void distance_field_recompute(distance_field_t* field) {
+    if (!field) return;
+
+    for (int i = 0; i < field->cell_count; i++) {
+        field->distance[i] = DISTANCE_INFINITE;
+    }
+    field->stale = false;
+    field->full_updates++;
+
+    int target = field->target;
+    if (target < 0 || target >= field->cell_count || field->blocked[target]) return;
+
+    field->distance[target] = 0;
+    field->queue[0] = target;
+    distance_field_spread(field, 0, 1);
+}
+
+static int distance_field_compare_seeds(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/******************************************************************************
+ * @brief 标记格子被占用（蛇头进入），增量更新距离
+ * 
+ * 1. 从该格子出发，按距离递增找出所有最短路径都经过它的格子：
+ *    一个格子只要还有距离小 1 的有效邻居就仍然成立，否则失效并检查它的后继
+ * 2. 失效区域的边界格子取有效邻居的最小距离加 1 作为种子，按距离排序后
+ *    与 BFS 队列归并，重新填满失效区域
+ * 
+ * 代价与失效区域大小成正比，目标被占用时改为标记过期
+ * 
+ * @param field 距离场指针
+ * @param cell 格子下标
+ *****************************************************************************/
+void distance_field_block(distance_field_t* field, int cell) {
+    if (!field || !distance_field_is_interior(field, cell) || field->blocked[cell]) return;
+
+    field->blocked[cell] = 1;
+    if (field->stale) return;
+    if (cell == field->target) {
+        field->stale = true;
+        return;
+    }
+
+    int32_t blocked_distance = field->distance[cell];
+    field->distance[cell] = DISTANCE_INFINITE;
+    if (blocked_distance == DISTANCE_INFINITE) return;
+    field->incremental_updates++;
+
+    if (++field->generation == 0) {
+        memset(field->stamps, 0, sizeof(uint32_t) * field->cell_count);
+        field->generation = 1;
+    }
+    uint32_t generation = field->generation;
+    const int steps[4] = {-field->width, field->width, -1, 1};
+    int32_t* distance = field->distance;
+    int head = 0;
+    int tail = 0;
+
+    // Invalidate the cells that lost their last shortest path
+    for (int d = 0; d < 4; d++) {
+        int next = cell + steps[d];
+        if (!field->blocked[next] && distance[next] == blocked_distance + 1) {
+            field->stamps[next] = generation;
+            field->queue[tail++] = next;
+        }
+    }
+
+    int affected = 0;
+    while (head < tail) {
+        int current = field->queue[head++];
+        int32_t current_distance = distance[current];
+        bool supported = false;
+
+        for (int d = 0; d < 4 && !supported; d++) {
+            int next = current + steps[d];
+            supported = !field->blocked[next] && distance[next] == current_distance - 1;
+        }
+        if (supported) continue;
+
+        distance[current] = DISTANCE_INFINITE;
+        field->affected[affected++] = current;
+        for (int d = 0; d < 4; d++) {
+            int next = current + steps[d];
+            if (!field->blocked[next] && field->stamps[next] != generation &&
+                distance[next] == current_distance + 1) {
+                field->stamps[next] = generation;
+                field->queue[tail++] = next;
+            }
+        }
+    }
+    if (affected == 0) return;
+
+    // Refill the region from its valid border, seeds in distance order
+    int seed_count = 0;
+    for (int i = 0; i < affected; i++) {
+        int current = field->affected[i];
+        int32_t best = DISTANCE_INFINITE;
+
+        for (int d = 0; d < 4; d++) {
+            int next = current + steps[d];
+            if (!field->blocked[next] && distance[next] < best - 1) {
+                best = distance[next] + 1;
+            }
+        }
+        if (best != DISTANCE_INFINITE) {
+            field->seeds[seed_count++] = (uint64_t)best << 32 | (uint32_t)current;
+        }
+    }
+    qsort(field->seeds, seed_count, sizeof(uint64_t), distance_field_compare_seeds);
+
+    head = 0;
+    tail = 0;
+    int seed = 0;
+    while (seed < seed_count || head < tail) {
+        int current;
+        if (head == tail ||
+            (seed < seed_count && (int32_t)(field->seeds[seed] >> 32) <= distance[field->queue[head]])) {
+            int32_t seed_distance = (int32_t)(field->seeds[seed] >> 32);
+            current = (int)(uint32_t)field->seeds[seed++];
+            if (seed_distance >= distance[current]) continue;
+            distance[current] = seed_distance;
+        } else {
+            current = field->queue[head++];
+        }
+
+        int32_t next_distance = distance[current] + 1;
+        for (int d = 0; d < 4; d++) {
+            int next = current + steps[d];
+            if (field->blocked[next] || distance[next] <= next_distance) continue;
+            distance[next] = next_distance;
+            field->queue[tail++] = next;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 标记格子被释放（蛇尾离开），增量更新距离
+ * 
+ * 释放只会让距离变短：该格子取邻居最小距离加 1，再向外扩散
+ * 
+ * @param field 距离场指针
+ * @param cell 格子下标
+ *****************************************************************************/
+void distance_field_unblock(distance_field_t* field, int cell) {
+    if (!field || !distance_field_is_interior(field, cell) || !field->blocked[cell]) return;
+
+    field->blocked[cell] = 0;
+    if (field->stale) return;
+    if (cell == field->target) {
+        field->stale = true;
+        return;
+    }
+
+    const int steps[4] = {-field->width, field->width, -1, 1};
+    int32_t best = DISTANCE_INFINITE;
+    for (int d = 0; d < 4; d++) {
+        int next = cell + steps[d];
+        if (!field->blocked[next] && field->distance[next] < best - 1) {
+            best = field->distance[next] + 1;
+        }
+    }
+    if (best == DISTANCE_INFINITE) return;
+
+    field->incremental_updates++;
+    field->distance[cell] = best;
+    field->queue[0] = cell;
+    distance_field_spread(field, 0, 1);
+}
+
+/******************************************************************************
+ * @brief 查询格子到目标的距离
+ * 
+ * 距离场过期时先整体重算
+ * 
+ * @param field 距离场指针
+ * @param cell 格子下标
+ * @return int 步数，无法到达返回 DISTANCE_FIELD_UNREACHABLE
+ *****************************************************************************/
+int distance_field_get(distance_field_t* field, int cell) {
+    if (!field || cell < 0 || cell >= field->cell_count) return DISTANCE_FIELD_UNREACHABLE;
+
+    if (field->stale) {
+        distance_field_recompute(field);
+    }
+
+    int32_t distance = field->distance[cell];
+    return distance == DISTANCE_INFINITE ? DISTANCE_FIELD_UNREACHABLE : distance;
+}
@@ -0,0 +1,55 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include "game.h"
+#include "arena.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Returned for cells the target cannot be reached from
+#define DISTANCE_FIELD_UNREACHABLE  -1
+
+// Breadth-first distance from every cell to a target cell (the food),
+// moving around walls and the snake body. Cells use the occupancy grid's
+// indices; the board border must stay blocked.
+//
+// Moving the target only marks the field stale; the next query runs one
+// full BFS. A body change touches only the cells it affects: freeing a
+// cell spreads the shorter distances it opens up, and blocking one
+// invalidates the cells whose every shortest path ran through it, then
+// recomputes them from the cells around that region.
+struct distance_field {
+    int width;              // Board width including border
+    int height;             // Board height including border
+    int cell_count;
+    int target;             // Target cell, -1 for none
+    bool stale;             // Distances must be rebuilt before the next query
+
+    int32_t* distance;      // Moves to the target, INT32_MAX when unreachable
+    unsigned char* blocked; // Walls and body
+    int* queue;
+    int* affected;          // Cells invalidated by the last block
+    uint64_t* seeds;        // Boundary distances of the invalidated region, distance << 32 | cell
+    uint32_t generation;
+    uint32_t* stamps;       // Queued mark per cell for the invalidation pass
+
+    long full_updates;      // BFS runs over the whole board
+    long incremental_updates; // Block and unblock updates applied in place
+    arena_t* arena;         // Owner of the memory, NULL for the heap
+};
+
+// Field management
+distance_field_t* distance_field_create(int width, int height, arena_t* arena);
+void distance_field_destroy(distance_field_t* field);
+void distance_field_clear(distance_field_t* field);
+
+// Updates
+void distance_field_set_target(distance_field_t* field, int cell);
+void distance_field_block(distance_field_t* field, int cell);
+void distance_field_unblock(distance_field_t* field, int cell);
+void distance_field_recompute(distance_field_t* field);
+
+// Queries
+int distance_field_get(distance_field_t* field, int cell);
+
+#endif // DISTANCE_FIELD_H
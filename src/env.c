@@ -0,0 +1,341 @@
+#include "env.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Opposite directions differ only in the lowest bit (UP/DOWN, LEFT/RIGHT)
+#define ENV_OPPOSITE(dir) ((dir) ^ 1)
+
+/******************************************************************************
+ * @brief 标记格子被占用，空格子从空闲列表中移除
+ * 
+ * @param cells 占用计数
+ * @param free_cells 空闲格子列表
+ * @param free_slots 每个格子在空闲列表中的位置
+ * @param free_count 空闲格子数
+ * @param cell 格子下标
+ *****************************************************************************/
+static inline void env_occupy(uint8_t* cells, int32_t* free_cells, int32_t* free_slots,
+                              int32_t* free_count, int cell) {
+    if (cells[cell]++ == 0) {
+        int slot = free_slots[cell];
+        int last = free_cells[--*free_count];
+        free_cells[slot] = last;
+        free_slots[last] = slot;
+        free_slots[cell] = -1;
+    }
+}
+
+/******************************************************************************
+ * @brief 释放格子，变空时放回空闲列表
+ * 
+ * 只会释放蛇身所在的内部格子，边框格子的计数始终不为 0
+ * 
+ * @param cells 占用计数
+ * @param free_cells 空闲格子列表
+ * @param free_slots 每个格子在空闲列表中的位置
+ * @param free_count 空闲格子数
+ * @param cell 格子下标
+ *****************************************************************************/
+static inline void env_vacate(uint8_t* cells, int32_t* free_cells, int32_t* free_slots,
+                              int32_t* free_count, int cell) {
+    if (--cells[cell] == 0) {
+        free_slots[cell] = *free_count;
+        free_cells[(*free_count)++] = cell;
+    }
+}
+
+/******************************************************************************
+ * @brief 在随机空闲格子生成食物
+ * 
+ * 与 food_find_valid_position 使用相同的随机数抽取方式
+ * 
+ * @param env 批量环境指针
+ * @param i 游戏序号
+ *****************************************************************************/
+static inline void env_spawn_food(snake_env_t* env, int i) {
+    int free_count = env->free_count[i];
+    if (free_count == 0) {
+        env->food[i] = -1; // Board is full, nowhere to spawn
+        return;
+    }
+
+    int32_t* free_cells = env->free_cells + (size_t)i * env->cell_count;
+    env->food[i] = free_cells[rng_range(&env->rng[i], 0, free_count - 1)];
+}
+
+/******************************************************************************
+ * @brief 重新开始第 i 局游戏
+ * 
+ * 与 game_change_level 相同：用 next_seed 初始化随机数并派生下一局种子，
+ * 复制空棋盘，在中心放置长度为 1、向右的蛇，然后生成食物
+ * 
+ * @param env 批量环境指针
+ * @param i 游戏序号
+ *****************************************************************************/
+static void env_reset_game(snake_env_t* env, int i) {
+    size_t cells_offset = (size_t)i * env->cell_count;
+    uint8_t* cells = env->cells + cells_offset;
+    int32_t* free_cells = env->free_cells + cells_offset;
+    int32_t* free_slots = env->free_slots + cells_offset;
+
+    env->seed[i] = env->next_seed[i];
+    env->next_seed[i] = rng_mix_seed(env->seed[i]);
+    rng_seed(&env->rng[i], env->seed[i]);
+
+    memcpy(cells, env->initial_cells, (size_t)env->cell_count);
+    memcpy(free_cells, env->initial_free_cells, sizeof(int32_t) * env->initial_free_count);
+    memcpy(free_slots, env->initial_free_slots, sizeof(int32_t) * env->cell_count);
+    env->free_count[i] = env->initial_free_count;
+
+    int start = (env->height / 2) * env->width + env->width / 2;
+    env->body[(size_t)i * env->capacity] = start;
+    env->head[i] = 0;
+    env->length[i] = 1;
+    env->direction[i] = DIR_RIGHT;
+    env->grow[i] = 0;
+    env->score[i] = 0;
+    env->steps[i] = 0;
+    env_occupy(cells, free_cells, free_slots, &env->free_count[i], start);
+
+    env_spawn_food(env, i);
+}
+
+/******************************************************************************
+ * @brief 创建批量游戏环境
+ * 
+ * 所有游戏的状态按数组结构一次性分配，之后步进和重置都不再分配内存。
+ * 第 i 局的初始种子由 seed 派生，第 0 局直接使用 seed
+ * 
+ * @param num_envs 同时运行的游戏数
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param seed 随机种子
+ * @return snake_env_t* 批量环境指针，失败返回 NULL
+ *****************************************************************************/
+snake_env_t* snake_env_create(int num_envs, int width, int height, uint64_t seed) {
+    if (num_envs < 1 || width < 4 || height < 4) return NULL;
+
+    snake_env_t* env = calloc(1, sizeof(snake_env_t));
+    if (!env) return NULL;
+
+    size_t n = (size_t)num_envs;
+    env->num_envs = num_envs;
+    env->width = width;
+    env->height = height;
+    env->cell_count = width * height;
+    // One spare slot so a snake filling the board can still grow into a wall
+    env->capacity = (width - 2) * (height - 2) + 1;
+    env->offsets[DIR_UP] = -width;
+    env->offsets[DIR_DOWN] = width;
+    env->offsets[DIR_LEFT] = -1;
+    env->offsets[DIR_RIGHT] = 1;
+
+    env->head = malloc(sizeof(int32_t) * n);
+    env->length = malloc(sizeof(int32_t) * n);
+    env->food = malloc(sizeof(int32_t) * n);
+    env->free_count = malloc(sizeof(int32_t) * n);
+    env->score = malloc(sizeof(int32_t) * n);
+    env->steps = malloc(sizeof(int32_t) * n);
+    env->direction = malloc(n);
+    env->grow = malloc(n);
+    env->seed = malloc(sizeof(uint64_t) * n);
+    env->next_seed = malloc(sizeof(uint64_t) * n);
+    env->rng = malloc(sizeof(rng_t) * n);
+
+    env->body = malloc(sizeof(int32_t) * n * env->capacity);
+    env->cells = malloc(n * env->cell_count);
+    env->free_cells = malloc(sizeof(int32_t) * n * env->cell_count);
+    env->free_slots = malloc(sizeof(int32_t) * n * env->cell_count);
+
+    env->initial_cells = malloc((size_t)env->cell_count);
+    env->initial_free_cells = malloc(sizeof(int32_t) * env->cell_count);
+    env->initial_free_slots = malloc(sizeof(int32_t) * env->cell_count);
+
+    if (!env->head || !env->length || !env->food || !env->free_count ||
+        !env->score || !env->steps || !env->direction || !env->grow ||
+        !env->seed || !env->next_seed || !env->rng || !env->body ||
+        !env->cells || !env->free_cells || !env->free_slots ||
+        !env->initial_cells || !env->initial_free_cells || !env->initial_free_slots) {
+        snake_env_destroy(env);
+        return NULL;
+    }
+
+    // Build the empty board in the same free list order as grid_clear
+    for (int cell = 0; cell < env->cell_count; cell++) {
+        int x = cell % width;
+        int y = cell / width;
+        bool interior = x > 0 && x < width - 1 && y > 0 && y < height - 1;
+
+        env->initial_cells[cell] = interior ? 0 : 1;
+        env->initial_free_slots[cell] = -1;
+        if (interior) {
+            env->initial_free_slots[cell] = env->initial_free_count;
+            env->initial_free_cells[env->initial_free_count++] = cell;
+        }
+    }
+
+    for (int i = 0; i < num_envs; i++) {
+        env->next_seed[i] = seed;
+        seed = rng_mix_seed(seed ^ 0xD1B54A32D192ED03ULL);
+    }
+
+    snake_env_reset(env);
+    return env;
+}
+
+/******************************************************************************
+ * @brief 销毁批量游戏环境
+ * 
+ * @param env 批量环境指针
+ *****************************************************************************/
+void snake_env_destroy(snake_env_t* env) {
+    if (!env) return;
+
+    free(env->head);
+    free(env->length);
+    free(env->food);
+    free(env->free_count);
+    free(env->score);
+    free(env->steps);
+    free(env->direction);
+    free(env->grow);
+    free(env->seed);
+    free(env->next_seed);
+    free(env->rng);
+    free(env->body);
+    free(env->cells);
+    free(env->free_cells);
+    free(env->free_slots);
+    free(env->initial_cells);
+    free(env->initial_free_cells);
+    free(env->initial_free_slots);
+    free(env);
+}
+
+/******************************************************************************
+ * @brief 重新开始所有游戏
+ * 
+ * 每局使用各自的下一个种子
+ * 
+ * @param env 批量环境指针
+ *****************************************************************************/
+void snake_env_reset(snake_env_t* env) {
+    if (!env) return;
+
+    for (int i = 0; i < env->num_envs; i++) {
+        env_reset_game(env, i);
+    }
+}
+
+/******************************************************************************
+ * @brief 所有游戏各走一步
+ * 
+ * 每局按 game_tick 的顺序执行：应用动作（反向动作被忽略）、移动蛇、
+ * 检查食物、检查碰撞。结束的游戏（死亡、占满棋盘或达到 max_steps）立即重新开始，
+ * 本步的奖励和结束标志仍属于结束的那一局
+ * 
+ * @param env 批量环境指针
+ * @param actions 每局的方向（direction_t），NULL 表示保持当前方向
+ * @param rewards 输出每局奖励，可以为 NULL
+ * @param dones 输出每局是否结束，可以为 NULL
+ *****************************************************************************/
+void snake_env_step(snake_env_t* env, const uint8_t* actions,
+                    float* rewards, uint8_t* dones) {
+    if (!env) return;
+
+    const int capacity = env->capacity;
+    const int cell_count = env->cell_count;
+
+    for (int i = 0; i < env->num_envs; i++) {
+        int32_t* body = env->body + (size_t)i * capacity;
+        uint8_t* cells = env->cells + (size_t)i * cell_count;
+        int32_t* free_cells = env->free_cells + (size_t)i * cell_count;
+        int32_t* free_slots = env->free_slots + (size_t)i * cell_count;
+        int32_t* free_count = &env->free_count[i];
+
+        // Apply the action
+        int dir = env->direction[i];
+        if (actions) {
+            int action = actions[i] & 3;
+            if (action != ENV_OPPOSITE(dir)) {
+                dir = action;
+                env->direction[i] = (uint8_t)dir;
+            }
+        }
+
+        // Move: pop the tail unless growing, then push the new head.
+        // A snake covering the whole board has nowhere left to grow.
+        int head = env->head[i];
+        int length = env->length[i];
+        int new_head = body[head] + env->offsets[dir];
+
+        if (!env->grow[i] || length >= capacity || *free_count == 0) {
+            int tail = head - (length - 1);
+            if (tail < 0) tail += capacity;
+            env_vacate(cells, free_cells, free_slots, free_count, body[tail]);
+            length--;
+        }
+        env->grow[i] = 0;
+
+        if (++head == capacity) head = 0;
+        body[head] = new_head;
+        env->head[i] = head;
+        env->length[i] = length + 1;
+        env_occupy(cells, free_cells, free_slots, free_count, new_head);
+
+        // Food
+        float reward = 0.0f;
+        if (new_head == env->food[i]) {
+            env->grow[i] = 1;
+            env->score[i]++;
+            reward = SNAKE_ENV_REWARD_FOOD;
+            env_spawn_food(env, i);
+        }
+
+        // Walls start at 1, so any count above 1 is a collision. A snake
+        // covering the whole board has won.
+        bool dead = cells[new_head] > 1;
+        bool won = !dead && *free_count == 0;
+        env->steps[i]++;
+        bool done = dead || won || (env->max_steps > 0 && env->steps[i] >= env->max_steps);
+
+        if (dead) {
+            reward = SNAKE_ENV_REWARD_DEATH;
+        }
+
+        if (rewards) rewards[i] = reward;
+        if (dones) dones[i] = done;
+
+        if (done) {
+            env->episodes++;
+            env_reset_game(env, i);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 获取第 i 局的占用计数
+ * 
+ * 数组按 y * width + x 索引，边框为 1，蛇身格子为 1，空格子为 0
+ * 
+ * @param env 批量环境指针
+ * @param index 游戏序号
+ * @return const uint8_t* 占用计数数组，序号无效返回 NULL
+ *****************************************************************************/
+const uint8_t* snake_env_get_cells(const snake_env_t* env, int index) {
+    if (!env || index < 0 || index >= env->num_envs) return NULL;
+    return env->cells + (size_t)index * env->cell_count;
+}
+
+/******************************************************************************
+ * @brief 获取第 i 局蛇头所在格子
+ * 
+ * @param env 批量环境指针
+ * @param index 游戏序号
+ * @return int 格子下标，序号无效返回 -1
+ *****************************************************************************/
+int snake_env_get_head_cell(const snake_env_t* env, int index) {
+    if (!env || index < 0 || index >= env->num_envs) return -1;
+    return env->body[(size_t)index * env->capacity + env->head[index]];
+}
@@ -0,0 +1,70 @@
+#ifndef ENV_H
+#define ENV_H
+
+#include "rng.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Rewards returned by snake_env_step
+#define SNAKE_ENV_REWARD_FOOD    1.0f
+#define SNAKE_ENV_REWARD_DEATH  -1.0f
+
+// Batch of independent games for bot training, stored as structure of
+// arrays and stepped in one loop without function pointers or allocation.
+//
+// The rules match game_tick: a game seeded with S plays exactly like a
+// game_t seeded with S on a board of the same size. Cells are indexed
+// y * width + x over the whole board including the border; border cells
+// start with an occupancy count of 1 so hitting a wall and hitting the
+// body are the same "count > 1" test.
+typedef struct snake_env {
+    int num_envs;
+    int width;              // Board width including border
+    int height;             // Board height including border
+    int cell_count;         // width * height
+    int capacity;           // Body ring buffer size per game
+    int offsets[4];         // Cell index delta per direction_t
+    long max_steps;         // Truncate games after this many steps, 0 for none
+
+    // Per-game state, indexed by game
+    int32_t* head;          // Ring buffer slot of the head
+    int32_t* length;
+    int32_t* food;          // Cell of the food, -1 when the board is full
+    int32_t* free_count;
+    int32_t* score;         // Food eaten this game
+    int32_t* steps;         // Steps taken this game
+    uint8_t* direction;
+    uint8_t* grow;          // Grow on the next step
+    uint64_t* seed;         // Seed of the current game
+    uint64_t* next_seed;    // Seed the next game will use
+    rng_t* rng;
+
+    // Per-game slabs, game i owns entries [i * stride, (i + 1) * stride)
+    int32_t* body;          // Ring buffer of cells, stride capacity
+    uint8_t* cells;         // Occupancy counts, stride cell_count
+    int32_t* free_cells;    // Free interior cells, stride cell_count
+    int32_t* free_slots;    // Slot of each cell in free_cells or -1, stride cell_count
+
+    // Empty board copied in on every reset
+    uint8_t* initial_cells;
+    int32_t* initial_free_cells;
+    int32_t* initial_free_slots;
+    int initial_free_count;
+
+    long episodes;          // Games finished since creation
+} snake_env_t;
+
+// Batch management
+snake_env_t* snake_env_create(int num_envs, int width, int height, uint64_t seed);
+void snake_env_destroy(snake_env_t* env);
+void snake_env_reset(snake_env_t* env);
+
+// Stepping
+void snake_env_step(snake_env_t* env, const uint8_t* actions,
+                    float* rewards, uint8_t* dones);
+
+// Observation
+const uint8_t* snake_env_get_cells(const snake_env_t* env, int index);
+int snake_env_get_head_cell(const snake_env_t* env, int index);
+
+#endif // ENV_H
@@ -1,6 +1,8 @@
 #include "food.h"
 #include "snake.h"
+#include "grid.h"
 #include "score.h"
+#include "zobrist.h"
 #include <stdlib.h>
 
 // Static food type instances
@@ -16,15 +18,18 @@ static food_type_t apple_type = {
  * 
  * 分配并初始化食物结构体，初始状态为非激活
  * 
+ * @param arena 内存池，NULL 表示从堆上分配
  * @return food_t* 食物实例指针，失败返回 NULL
  *****************************************************************************/
-food_t* food_create(void) {
-    food_t* food = malloc(sizeof(food_t));
+food_t* food_create(arena_t* arena) {
+    food_t* food = arena_alloc(arena, sizeof(food_t));
     if (!food) return NULL;
 
     food->position = point_create(0, 0);
     food->type = &apple_type;
     food->active = false;
+    food->hash = 0;
+    food->arena = arena;
 
     return food;
 }
@@ -36,14 +41,15 @@ food_t* food_create(void) {
  *****************************************************************************/
 void food_destroy(food_t* food) {
     if (food) {
-        free(food);
+        arena_free(food->arena, food);
     }
 }
 
 /******************************************************************************
  * @brief 在有效位置生成食物
  * 
- * 在游戏区域内找到一个有效位置（不在蛇身上）并激活食物
+ * 在游戏区域内找到一个有效位置（不在蛇身上）并激活食物。
+ * 棋盘已被蛇占满时食物保持非激活状态
  * 
  * @param food 食物实例指针
  * @param game 游戏实例指针
@@ -51,9 +57,16 @@ void food_destroy(food_t* food) {
 void food_spawn(food_t* food, game_t* game) {
     if (!food || !game) return;
 
+    if (game->grid && grid_free_count(game->grid) == 0) {
+        food->active = false; // Board is full, nowhere to spawn
+        food->hash = 0;
+        return;
+    }
+
     food->position = food_find_valid_position(game);
     food->type = &apple_type; // For now, always spawn apples
     food->active = true;
+    food->hash = zobrist_point_key(ZOBRIST_FOOD, food->position);
 }
 
 /******************************************************************************
@@ -73,6 +86,7 @@ void food_consume(food_t* food, game_t* game) {
     }
 
     food->active = false;
+    food->hash = 0;
 }
 
 /******************************************************************************
@@ -90,8 +104,9 @@ bool food_is_at_position(food_t* food, point_t position) {
 /******************************************************************************
  * @brief 查找有效的食物生成位置
  * 
- * 在游戏区域内随机查找一个有效位置（不在蛇身上，不在边框上）
- * 最多尝试 100 次，失败则返回中心位置
+ * 在游戏区域内随机查找一个有效位置（不在蛇身上，不在边框上）。
+ * 有占用网格时从空闲格子索引中均匀选取（O(1)，与棋盘拥挤程度无关）；
+ * 否则最多随机尝试 100 次，失败则返回中心位置
  * 
  * @param game 游戏实例指针
  * @return point_t 有效位置坐标
@@ -99,15 +114,21 @@ bool food_is_at_position(food_t* food, point_t position) {
 point_t food_find_valid_position(game_t* game) {
     if (!game) return point_create(0, 0);
 
+    // Pick a uniformly random empty cell from the free cell index
+    int free_count = grid_free_count(game->grid);
+    if (free_count > 0) {
+        return grid_get_free_cell(game->grid, rng_range(&game->rng, 0, free_count - 1));
+    }
+
     point_t position;
     int max_attempts = 100;
     int attempts = 0;
 
     do {
         // Generate random position within game board
-        int x = get_random(game->board_offset_x + 1,
+        int x = rng_range(&game->rng, game->board_offset_x + 1,
                           game->board_offset_x + game->board_width - 2);
-        int y = get_random(game->board_offset_y + 1,
+        int y = rng_range(&game->rng, game->board_offset_y + 1,
                           game->board_offset_y + game->board_height - 2);
         position = point_create(x, y);
         attempts++;
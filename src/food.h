@@ -3,17 +3,21 @@
 
 #include "game.h"
 #include "utils.h"
+#include "arena.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 // Food structure
 struct food {
     point_t position;
     food_type_t* type;
     bool active;
+    uint64_t hash;          // Zobrist key of the position while active, see zobrist.h
+    arena_t* arena;         // Owner of the memory, NULL for the heap
 };
 
 // Food creation and destruction
-food_t* food_create(void);
+food_t* food_create(arena_t* arena);
 void food_destroy(food_t* food);
 
 // Food operations
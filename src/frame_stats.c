@@ -0,0 +1,222 @@
+#include "frame_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_STATS_RING_MASK (FRAME_STATS_RING_SIZE - 1)
+
+static const char* frame_phase_names[FRAME_PHASE_COUNT] = {
+    "frame", "input", "update", "render", "refresh", "slip"
+};
+
+/******************************************************************************
+ * @brief 创建帧统计
+ * 
+ * @return frame_stats_t* 帧统计指针，失败返回 NULL
+ *****************************************************************************/
+frame_stats_t* frame_stats_create(void) {
+    return calloc(1, sizeof(frame_stats_t));
+}
+
+/******************************************************************************
+ * @brief 销毁帧统计
+ * 
+ * @param stats 帧统计指针
+ *****************************************************************************/
+void frame_stats_destroy(frame_stats_t* stats) {
+    free(stats);
+}
+
+/******************************************************************************
+ * @brief 计算数值所在的直方图桶
+ * 
+ * 小于 SUB_COUNT 的值各占一个桶；更大的值按最高位所在的 2 的幂分段，
+ * 每段再按紧随最高位的 SUB_BITS 位等分
+ *****************************************************************************/
+static inline int frame_histogram_index(uint64_t value) {
+    int magnitude = 63 - __builtin_clzll(value | 1);
+    if (magnitude < FRAME_HISTOGRAM_SUB_BITS) return (int)value;
+
+    int shift = magnitude - FRAME_HISTOGRAM_SUB_BITS;
+    return shift * FRAME_HISTOGRAM_SUB_COUNT + (int)(value >> shift);
+}
+
+/******************************************************************************
+ * @brief 计算直方图桶能表示的最大值
+ *****************************************************************************/
+static inline int64_t frame_histogram_upper_bound(int index) {
+    if (index < 2 * FRAME_HISTOGRAM_SUB_COUNT) return index;
+
+    int shift = index / FRAME_HISTOGRAM_SUB_COUNT - 1;
+    uint64_t mantissa = (uint64_t)(index - shift * FRAME_HISTOGRAM_SUB_COUNT);
+    uint64_t upper = ((mantissa + 1) << shift) - 1;
+    return upper > INT64_MAX ? INT64_MAX : (int64_t)upper;
+}
+
+/******************************************************************************
+ * @brief 向直方图加入一个值
+ * 
+ * @param histogram 直方图指针
+ * @param value 纳秒数，负数按 0 计
+ *****************************************************************************/
+void frame_histogram_add(frame_histogram_t* histogram, int64_t value) {
+    if (!histogram) return;
+    if (value < 0) value = 0;
+
+    histogram->buckets[frame_histogram_index((uint64_t)value)]++;
+    histogram->count++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/******************************************************************************
+ * @brief 获取直方图的百分位数
+ * 
+ * 返回该百分位所在桶的上界（不超过最大值），相对误差不超过 1/SUB_COUNT
+ * 
+ * @param histogram 直方图指针
+ * @param percentile 百分位（0-100）
+ * @return int64_t 百分位数（纳秒），直方图为空返回 0
+ *****************************************************************************/
+int64_t frame_histogram_percentile(const frame_histogram_t* histogram, double percentile) {
+    if (!histogram || histogram->count == 0) return 0;
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < FRAME_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            int64_t upper = frame_histogram_upper_bound(i);
+            return upper < histogram->max ? upper : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/******************************************************************************
+ * @brief 记录一帧
+ * 
+ * 写入环形缓冲区的下一个槽位后再用 release 语义发布，然后更新各阶段
+ * 的直方图。节拍延迟只统计执行了节拍的帧
+ * 
+ * @param stats 帧统计指针
+ * @param sample 本帧的计时
+ *****************************************************************************/
+void frame_stats_record(frame_stats_t* stats, const frame_sample_t* sample) {
+    if (!stats || !sample) return;
+
+    uint64_t written = __atomic_load_n(&stats->written, __ATOMIC_RELAXED);
+    stats->ring[written & FRAME_STATS_RING_MASK] = *sample;
+    __atomic_store_n(&stats->written, written + 1, __ATOMIC_RELEASE);
+
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+        if (phase == FRAME_PHASE_SLIP && sample->ticks == 0) continue;
+        frame_histogram_add(&stats->histograms[phase], sample->phase_ns[phase]);
+    }
+}
+
+/******************************************************************************
+ * @brief 复制最近记录的帧（可在其他线程调用，不加锁）
+ * 
+ * 复制完成后重新读取写入计数，丢弃复制期间可能被写入者覆盖的最旧槽位，
+ * 与顺序锁的读端相同
+ * 
+ * @param stats 帧统计指针
+ * @param out 输出数组，从旧到新
+ * @param max_count 输出数组容量
+ * @return int 复制的帧数
+ *****************************************************************************/
+int frame_stats_copy_recent(const frame_stats_t* stats, frame_sample_t* out, int max_count) {
+    if (!stats || !out || max_count <= 0) return 0;
+
+    uint64_t end = __atomic_load_n(&stats->written, __ATOMIC_ACQUIRE);
+    uint64_t count = end < FRAME_STATS_RING_SIZE ? end : FRAME_STATS_RING_SIZE;
+    if (count > (uint64_t)max_count) count = (uint64_t)max_count;
+    uint64_t begin = end - count;
+
+    for (uint64_t i = 0; i < count; i++) {
+        out[i] = stats->ring[(begin + i) & FRAME_STATS_RING_MASK];
+    }
+
+    // The writer may be filling the slot of frame `now` - RING_SIZE
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t now = __atomic_load_n(&stats->written, __ATOMIC_RELAXED);
+    uint64_t valid_from = now + 1 > FRAME_STATS_RING_SIZE ? now + 1 - FRAME_STATS_RING_SIZE : 0;
+    if (valid_from > begin) {
+        uint64_t torn = valid_from - begin;
+        if (torn >= count) return 0;
+        memmove(out, out + torn, sizeof(frame_sample_t) * (count - torn));
+        count -= torn;
+    }
+
+    return (int)count;
+}
+
+/******************************************************************************
+ * @brief 获取阶段名称
+ * 
+ * @param phase 阶段
+ * @return const char* 阶段名称
+ *****************************************************************************/
+const char* frame_phase_name(frame_phase_t phase) {
+    if (phase < 0 || phase >= FRAME_PHASE_COUNT) return "unknown";
+    return frame_phase_names[phase];
+}
+
+/******************************************************************************
+ * @brief 将帧统计写入文件
+ * 
+ * 先输出每个阶段的百分位汇总，再以 CSV 输出环形缓冲区中最近的各帧
+ * 
+ * @param stats 帧统计指针
+ * @param path 输出文件路径
+ * @return bool 成功返回 true，否则返回 false
+ *****************************************************************************/
+bool frame_stats_dump(const frame_stats_t* stats, const char* path) {
+    if (!stats || !path) return false;
+
+    frame_sample_t* samples = malloc(sizeof(frame_sample_t) * FRAME_STATS_RING_SIZE);
+    if (!samples) return false;
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        free(samples);
+        return false;
+    }
+
+    fprintf(file, "phase,count,p50_us,p90_us,p99_us,p999_us,max_us\n");
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+        const frame_histogram_t* histogram = &stats->histograms[phase];
+        fprintf(file, "%s,%llu,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+                frame_phase_name((frame_phase_t)phase),
+                (unsigned long long)histogram->count,
+                frame_histogram_percentile(histogram, 50) / 1e3,
+                frame_histogram_percentile(histogram, 90) / 1e3,
+                frame_histogram_percentile(histogram, 99) / 1e3,
+                frame_histogram_percentile(histogram, 99.9) / 1e3,
+                histogram->max / 1e3);
+    }
+
+    int count = frame_stats_copy_recent(stats, samples, FRAME_STATS_RING_SIZE);
+    int64_t origin = count > 0 ? samples[0].start_ns : 0;
+
+    fprintf(file, "\nstart_us,ticks");
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+        fprintf(file, ",%s_us", frame_phase_name((frame_phase_t)phase));
+    }
+    fprintf(file, "\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(file, "%.1f,%d", (samples[i].start_ns - origin) / 1e3, samples[i].ticks);
+        for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+            fprintf(file, ",%.1f", samples[i].phase_ns[phase] / 1e3);
+        }
+        fprintf(file, "\n");
+    }
+
+    free(samples);
+    return fclose(file) == 0;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include "game.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frames kept in the ring buffer (power of two)
+#define FRAME_STATS_RING_SIZE   4096
+
+// Histogram precision: 2^SUB_BITS buckets per power of two, so every
+// recorded value is within 1/32 (about 3%) of its bucket's bounds
+#define FRAME_HISTOGRAM_SUB_BITS    5
+#define FRAME_HISTOGRAM_SUB_COUNT   (1 << FRAME_HISTOGRAM_SUB_BITS)
+#define FRAME_HISTOGRAM_BUCKETS     ((64 - FRAME_HISTOGRAM_SUB_BITS + 1) * FRAME_HISTOGRAM_SUB_COUNT)
+
+// Phases of one main loop iteration
+typedef enum {
+    FRAME_PHASE_FRAME = 0,  // Whole frame, waiting excluded
+    FRAME_PHASE_INPUT,      // Key handling and state transitions
+    FRAME_PHASE_UPDATE,     // game_update calls of the ticks that were due
+    FRAME_PHASE_RENDER,     // game_render without the screen refresh
+    FRAME_PHASE_REFRESH,    // Renderer refresh (ncurses refresh())
+    FRAME_PHASE_SLIP,       // Lateness of the frame's last tick, frames with ticks only
+    FRAME_PHASE_COUNT
+} frame_phase_t;
+
+// One main loop iteration
+typedef struct {
+    int64_t start_ns;       // Monotonic time the frame started
+    int64_t phase_ns[FRAME_PHASE_COUNT];
+    int32_t ticks;          // Simulation ticks run in the frame
+} frame_sample_t;
+
+// Log-linear (HDR-style) histogram of nanosecond values: values below
+// 2^SUB_BITS get one bucket each, every power of two above that is split
+// into SUB_COUNT equal buckets. Covers the whole int64 range in a fixed
+// array, with constant relative error.
+typedef struct {
+    uint64_t count;
+    int64_t max;
+    uint64_t buckets[FRAME_HISTOGRAM_BUCKETS];
+} frame_histogram_t;
+
+// Per-frame timings of the interactive loop. The game thread is the only
+// writer: it fills the next ring slot and then publishes it by advancing
+// `written` with a release store, so a reader on another thread never
+// takes a lock (see frame_stats_copy_recent).
+struct frame_stats {
+    frame_sample_t ring[FRAME_STATS_RING_SIZE];
+    uint64_t written;       // Frames recorded so far, atomic
+    frame_histogram_t histograms[FRAME_PHASE_COUNT];
+    bool overlay;           // Draw the summary over the game screen
+};
+
+// Statistics management
+frame_stats_t* frame_stats_create(void);
+void frame_stats_destroy(frame_stats_t* stats);
+
+// Recording
+void frame_stats_record(frame_stats_t* stats, const frame_sample_t* sample);
+int frame_stats_copy_recent(const frame_stats_t* stats, frame_sample_t* out, int max_count);
+
+// Histograms
+void frame_histogram_add(frame_histogram_t* histogram, int64_t value);
+int64_t frame_histogram_percentile(const frame_histogram_t* histogram, double percentile);
+
+// Output
+const char* frame_phase_name(frame_phase_t phase);
+bool frame_stats_dump(const frame_stats_t* stats, const char* path);
+
+#endif // FRAME_STATS_H
@@ -1,13 +1,25 @@
 #include "game.h"
 #include "snake.h"
 #include "food.h"
+#include "grid.h"
 #include "score.h"
-#include "ui.h"
-#include "input.h"
+#include "replay.h"
+#include "autopilot.h"
+#include "hamilton.h"
+#include "mcts.h"
+#include "greedy.h"
+#include "distance_field.h"
+#include "frame_stats.h"
+#include "arena.h"
 #include "utils.h"
 #include <stdlib.h>
 #include <stdio.h>
 
+// Arena reserved at level start: structure headers plus the per-cell
+// arrays of the grid, bitboard, snake body and controller buffers
+#define GAME_ARENA_BASE_BYTES       4096
+#define GAME_ARENA_BYTES_PER_CELL   96
+
 // Level configurations
 static level_config_t level_configs[] = {
     {200, 1, "Easy", NULL, NULL, 1},        // Level 1
@@ -33,166 +45,171 @@ game_t* game_create(void) {
     game->next_state = STATE_START_SCREEN;
     game->snake = NULL;
     game->food = NULL;
+    game->grid = NULL;
+    game->arena = NULL;
     game->score = 0;
     game->high_score = 0;
     game->level = 1;
+    game->seed = 0;
+    game->next_seed = rng_seed_from_clock();
+    rng_seed(&game->rng, game->next_seed);
     game->selected_level = 1;
     game->board_width = 0;
     game->board_height = 0;
     game->board_offset_x = 0;
     game->board_offset_y = 0;
+    game->board_fixed = false;
+    game->tick_count = 0;
+    game->food_tick = 0;
+    game->won = false;
+    game->recorder = NULL;
+    game->player = NULL;
+    game->controller = NULL;
+    game->autopilot = NULL;
+    game->hamilton = NULL;
+    game->mcts = NULL;
+    game->mcts_unavailable = false;
+    game->food_distance = NULL;
     game->current_handler = NULL;
     game->level_config = NULL;
     game->renderer = NULL;
+    game->frame_stats = NULL;
+    game->render_dirty = RENDER_DIRTY_ALL;
     game->running = true;
     game->paused = false;
+    options_init(&game->options);
 
     return game;
 }
 
 /******************************************************************************
- * @brief 销毁游戏实例并释放资源
+ * @brief 释放本局的棋盘对象
  * 
- * 释放蛇、食物等游戏对象，最后释放 game 结构体本身
+ * 蛇、食物、网格和控制器缓冲区都在本局内存池中，destroy 只会释放
+ * 内存池创建失败时从堆上分配的部分，内存由随后的重置统一回收
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
-void game_destroy(game_t* game) {
-    if (!game) return;
-
-    if (game->snake) {
-        snake_destroy(game->snake);
-    }
+static void game_release_board(game_t* game) {
+    snake_destroy(game->snake);
+    food_destroy(game->food);
+    grid_destroy(game->grid);
+    autopilot_destroy(game->autopilot);
+    hamilton_destroy(game->hamilton);
+    distance_field_destroy(game->food_distance);
 
-    if (game->food) {
-        food_destroy(game->food);
-    }
-
-    free(game);
+    game->snake = NULL;
+    game->food = NULL;
+    game->grid = NULL;
+    game->autopilot = NULL;
+    game->hamilton = NULL;
+    game->food_distance = NULL;
 }
 
 /******************************************************************************
- * @brief 初始化游戏系统
+ * @brief 销毁游戏实例并释放资源
  * 
- * 初始化随机数生成器、分数系统、渲染器，并设置初始状态处理器
+ * 释放蛇、食物等游戏对象和本局内存池，最后释放 game 结构体本身
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
-void game_init(game_t* game) {
+void game_destroy(game_t* game) {
     if (!game) return;
 
-    // Initialize random number generator
-    init_random();
-
-    // Initialize score system
-    score_init(game);
+    game_release_board(game);
 
-    // Set up renderer
-    game->renderer = get_ncurses_renderer();
-    if (game->renderer && game->renderer->init) {
-        game->renderer->init();
+    if (game->recorder) {
+        replay_recorder_end_game(game->recorder, game->tick_count, false);
+        replay_recorder_close(game->recorder);
     }
 
-    // Check if terminal size is adequate
-    if (!is_terminal_size_valid()) {
-        printf("Terminal too small! Minimum size: %dx%d\n",
-               MIN_TERMINAL_WIDTH, MIN_TERMINAL_HEIGHT);
-        game->running = false;
-        return;
+    if (game->player) {
+        replay_player_close(game->player);
     }
 
-    // Calculate initial board size
-    game_calculate_board_size(game);
+    if (game->mcts) {
+        mcts_destroy(game->mcts);
+    }
 
-    // Set initial state handler
-    game->current_handler = get_start_screen_handler();
-    if (game->current_handler && game->current_handler->enter) {
-        game->current_handler->enter(game);
+    if (game->frame_stats) {
+        frame_stats_destroy(game->frame_stats);
     }
+
+    arena_destroy(game->arena);
+
+    free(game);
 }
 
 /******************************************************************************
- * @brief 运行游戏主循环
+ * @brief 执行一个游戏节拍
+ * 
+ * 不依赖终端的纯模拟逻辑：
+ * 0. 设置了控制器时由控制器选择方向
+ * 1. 移动蛇
+ * 2. 检查是否吃到食物，吃到则重新生成食物
+ * 3. 检查碰撞，发生碰撞则切换到游戏结束状态
+ * 4. 蛇占满整个棋盘时获胜，同样切换到游戏结束状态
  * 
- * 主循环流程:
- * 1. 处理用户输入
- * 2. 处理状态转换
- * 3. 根据时间间隔更新游戏逻辑
- * 4. 渲染画面
+ * 启用录制时记录本节拍的方向变化和游戏结束
  * 
  * @param game 游戏实例指针
+ * @return bool 蛇发生碰撞或占满棋盘（游戏结束）返回 true，否则返回 false
  *****************************************************************************/
-void game_run(game_t* game) {
-    if (!game) return;
+bool game_tick(game_t* game) {
+    if (!game || !game->snake) return false;
 
-    int last_update_time = 0;
-    int current_time = 0;
-
-    while (game->running) {
-        // Handle input
-        int key = input_get_key();
-        if (key != ERR) {
-            game_handle_input(game, key);
-        }
+    // Let the computer player steer
+    if (game->controller && game->controller->steer) {
+        game->controller->steer(game);
+    }
 
-        // Handle state transitions
-        if (game->state != game->next_state) {
-            if (game->current_handler && game->current_handler->exit) {
-                game->current_handler->exit(game);
-            }
-
-            game->state = game->next_state;
-
-            switch (game->state) {
-                case STATE_START_SCREEN:
-                    game->current_handler = get_start_screen_handler();
-                    break;
-                case STATE_PLAYING:
-                    game->current_handler = get_game_screen_handler();
-                    break;
-                case STATE_GAME_OVER:
-                    game->current_handler = get_game_over_handler();
-                    break;
-                case STATE_PAUSED:
-                    // Keep current handler but stop updating
-                    break;
-                case STATE_EXIT:
-                    game->running = false;
-                    continue;
-            }
-
-            if (game->current_handler && game->current_handler->enter) {
-                game->current_handler->enter(game);
-            }
-        }
+    direction_t previous_direction = game->snake->direction;
 
-        // Update game logic based on timing
-        current_time++; // Simple frame counter
-        int update_interval = game->level_config ? game->level_config->speed_delay / 10 : 20;
+    // Move snake
+    if (game->snake->behavior && game->snake->behavior->move_snake) {
+        game->snake->behavior->move_snake(game->snake, game);
+    }
 
-        if (game->state == STATE_PLAYING && !game->paused &&
-            current_time - last_update_time >= update_interval) {
-            game_update(game);
-            last_update_time = current_time;
+    // Check food collision
+    if (game->food && game->food->active) {
+        point_t head_pos = snake_get_head_position(game->snake);
+        if (food_is_at_position(game->food, head_pos)) {
+            food_consume(game->food, game);
+            food_spawn(game->food, game);
+            game->food_tick = game->tick_count;
         }
+    }
 
-        // Render
-        game_render(game);
-
-        // Small delay to prevent excessive CPU usage
-        sleep_ms(10);
+    if (game->snake->direction != previous_direction) {
+        replay_recorder_turn(game->recorder, game->tick_count,
+                             game->snake->direction);
+    }
+    game->tick_count++;
+
+    // Check collisions
+    if (game->snake->behavior && game->snake->behavior->check_collision) {
+        if (game->snake->behavior->check_collision(game->snake, game)) {
+            replay_recorder_end_game(game->recorder, game->tick_count, true);
+            game_set_state(game, STATE_GAME_OVER);
+            return true;
+        }
     }
 
-    // Cleanup
-    if (game->renderer && game->renderer->cleanup) {
-        game->renderer->cleanup();
+    // A snake covering the whole board has nowhere left to go: it has won
+    if (game->grid && grid_free_count(game->grid) == 0) {
+        game->won = true;
+        replay_recorder_end_game(game->recorder, game->tick_count, true);
+        game_set_state(game, STATE_GAME_OVER);
+        return true;
     }
+
+    return false;
 }
 
 /******************************************************************************
  * @brief 更新游戏逻辑
  * 
- * 调用当前状态处理器的 update 函数来更新游戏状态
+ * 调用当前状态处理器的 update 函数来更新游戏状态，并标记画面需要重绘
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
@@ -202,6 +219,7 @@ void game_update(game_t* game) {
     if (game->current_handler->update) {
         game->current_handler->update(game);
     }
+    game_mark_dirty(game, RENDER_DIRTY_UPDATE);
 }
 
 /******************************************************************************
@@ -256,12 +274,32 @@ void game_handle_input(game_t* game, int key) {
 void game_set_state(game_t* game, game_state_t new_state) {
     if (!game) return;
     game->next_state = new_state;
+    game_mark_dirty(game, RENDER_DIRTY_STATE);
+}
+
+/******************************************************************************
+ * @brief 标记画面需要重绘
+ * 
+ * 主循环只在有标记时渲染，渲染后清除所有标记
+ * 
+ * @param game 游戏实例指针
+ * @param reasons RENDER_DIRTY_* 标志的组合
+ *****************************************************************************/
+void game_mark_dirty(game_t* game, unsigned int reasons) {
+    if (!game) return;
+    game->render_dirty |= reasons;
 }
 
 /******************************************************************************
  * @brief 切换游戏难度等级
  * 
- * 更改难度等级并重置游戏元素（蛇、食物、分数）
+ * 更改难度等级并重置游戏元素（蛇、食物、分数）。
+ * 每局开始时用 next_seed 重新初始化随机数生成器，并派生下一局的种子，
+ * 因此指定初始种子后整个会话都可以精确复现。
+ * 
+ * 本局的所有对象（网格、蛇、食物、控制器缓冲区）都从按棋盘尺寸预留的
+ * 内存池中分配，上一局的内存通过重置内存池一次性回收，开局后的节拍
+ * 不再调用 malloc/free
  * 
  * @param game 游戏实例指针
  * @param level 难度等级 (1-5)
@@ -272,33 +310,67 @@ void game_change_level(game_t* game, int level) {
     game->level = level;
     game->level_config = get_level_config(level);
 
+    // Seed this game and derive the seed of the next one
+    game->seed = game->next_seed;
+    game->next_seed = rng_mix_seed(game->seed);
+    rng_seed(&game->rng, game->seed);
+
     // Reset game elements
     score_reset(game);
 
-    // Destroy existing snake and food
-    if (game->snake) {
-        snake_destroy(game->snake);
-        game->snake = NULL;
-    }
-
-    if (game->food) {
-        food_destroy(game->food);
-        game->food = NULL;
-    }
+    // Drop the previous game's objects, then rewind the memory they used
+    game_release_board(game);
 
     // Recalculate board size in case terminal was resized
     game_calculate_board_size(game);
 
+    size_t cells = (size_t)game->board_width * game->board_height;
+    size_t arena_bytes = GAME_ARENA_BASE_BYTES + GAME_ARENA_BYTES_PER_CELL * cells;
+    if (game->arena) {
+        arena_reset(game->arena);
+        arena_reserve(game->arena, arena_bytes);
+    } else {
+        game->arena = arena_create(arena_bytes); // NULL falls back to the heap
+    }
+
+    // Start a new game in the input log
+    replay_recorder_begin_game(game->recorder, game);
+    game->tick_count = 0;
+    game->food_tick = 0;
+    game->won = false;
+
+    // Create occupancy grid covering the board
+    game->grid = grid_create(game->board_width, game->board_height,
+                             game->board_offset_x, game->board_offset_y, game->arena);
+
     // Create new snake at center of board
     int start_x = game->board_offset_x + game->board_width / 2;
     int start_y = game->board_offset_y + game->board_height / 2;
-    game->snake = snake_create(start_x, start_y, DIR_RIGHT);
+    game->snake = snake_create(start_x, start_y, DIR_RIGHT,
+                               game->board_width * game->board_height, game->arena);
+    snake_attach_grid(game->snake, game->grid);
 
     // Create and spawn food
-    game->food = food_create();
+    game->food = food_create(game->arena);
     if (game->food) {
         food_spawn(game->food, game);
     }
+
+    // Let the computer player prepare for the new board
+    if (game->controller && game->controller->reset) {
+        game->controller->reset(game);
+    }
+}
+
+/******************************************************************************
+ * @brief 设置下一局游戏的随机种子
+ * 
+ * @param game 游戏实例指针
+ * @param seed 随机种子
+ *****************************************************************************/
+void game_set_seed(game_t* game, uint64_t seed) {
+    if (!game) return;
+    game->next_seed = seed;
 }
 
 /******************************************************************************
@@ -326,15 +398,32 @@ int get_max_levels(void) {
     return sizeof(level_configs) / sizeof(level_configs[0]);
 }
 
+/******************************************************************************
+ * @brief 获取电脑玩家对应的控制器
+ * 
+ * @param bot 电脑玩家类型
+ * @return controller_t* 控制器指针，BOT_NONE 返回 NULL
+ *****************************************************************************/
+controller_t* get_bot_controller(bot_mode_t bot) {
+    switch (bot) {
+        case BOT_AUTOPILOT: return get_autopilot_controller();
+        case BOT_HAMILTON:  return get_hamilton_controller();
+        case BOT_MCTS:      return get_mcts_controller();
+        case BOT_GREEDY:    return get_greedy_controller();
+        default:            return NULL;
+    }
+}
+
 /******************************************************************************
  * @brief 计算游戏区域尺寸
  * 
- * 根据终端尺寸计算游戏区域的大小和位置，预留 UI 显示空间
+ * 根据终端尺寸计算游戏区域的大小和位置，预留 UI 显示空间。
+ * 通过 game_set_board_size 固定了尺寸时保持不变
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
 void game_calculate_board_size(game_t* game) {
-    if (!game) return;
+    if (!game || game->board_fixed) return;
 
     int term_width, term_height;
     get_terminal_size(&term_width, &term_height);
@@ -363,6 +452,34 @@ void game_calculate_board_size(game_t* game) {
     if (game->board_offset_y + game->board_height > term_height - 4) {
         game->board_height = term_height - game->board_offset_y - 4;
     }
+
+    // Stay within the sizes the game supports
+    if (game->board_width > GAME_BOARD_MAX_SIZE) game->board_width = GAME_BOARD_MAX_SIZE;
+    if (game->board_height > GAME_BOARD_MAX_SIZE) game->board_height = GAME_BOARD_MAX_SIZE;
+}
+
+/******************************************************************************
+ * @brief 固定游戏区域尺寸
+ * 
+ * 用于无终端运行（模拟、回放），此后不再根据终端尺寸调整。
+ * 尺寸限制在 GAME_BOARD_MIN_SIZE 到 GAME_BOARD_MAX_SIZE 之间，
+ * 保留当前的区域位置
+ * 
+ * @param game 游戏实例指针
+ * @param width 区域宽度（含边框）
+ * @param height 区域高度（含边框）
+ *****************************************************************************/
+void game_set_board_size(game_t* game, int width, int height) {
+    if (!game) return;
+
+    if (width < GAME_BOARD_MIN_SIZE) width = GAME_BOARD_MIN_SIZE;
+    if (width > GAME_BOARD_MAX_SIZE) width = GAME_BOARD_MAX_SIZE;
+    if (height < GAME_BOARD_MIN_SIZE) height = GAME_BOARD_MIN_SIZE;
+    if (height > GAME_BOARD_MAX_SIZE) height = GAME_BOARD_MAX_SIZE;
+
+    game->board_width = width;
+    game->board_height = height;
+    game->board_fixed = true;
 }
 
 /******************************************************************************
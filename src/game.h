@@ -2,12 +2,23 @@
 #define GAME_H
 
 #include "utils.h"
+#include "options.h"
+#include "rng.h"
 #include <stdbool.h>
 
 // Forward declarations
 typedef struct snake snake_t;
 typedef struct food food_t;
+typedef struct grid grid_t;
 typedef struct game game_t;
+typedef struct replay_recorder replay_recorder_t;
+typedef struct replay_player replay_player_t;
+typedef struct autopilot autopilot_t;
+typedef struct hamilton hamilton_t;
+typedef struct mcts mcts_t;
+typedef struct distance_field distance_field_t;
+typedef struct frame_stats frame_stats_t;
+typedef struct arena arena_t;
 
 // Game states
 typedef enum {
@@ -18,6 +29,14 @@ typedef enum {
     STATE_EXIT
 } game_state_t;
 
+// Reasons the screen no longer matches the game, see game_mark_dirty
+#define RENDER_DIRTY_UPDATE     (1u << 0)   // game_update advanced the simulation
+#define RENDER_DIRTY_INPUT      (1u << 1)   // A key was handled
+#define RENDER_DIRTY_STATE      (1u << 2)   // A state transition was requested
+#define RENDER_DIRTY_RESIZE     (1u << 3)   // The terminal changed size
+#define RENDER_DIRTY_RETRY      (1u << 4)   // The last frame skipped data that was busy
+#define RENDER_DIRTY_ALL        0x1fu
+
 // Function pointer interfaces
 typedef struct {
     void (*update)(game_t* game);
@@ -40,13 +59,22 @@ typedef struct {
     void (*on_eaten)(game_t* game, food_t* food);
 } food_type_t;
 
+typedef struct {
+    const char* name;
+    void (*reset)(game_t* game);    // Prepare for a new game, may be NULL
+    void (*steer)(game_t* game);    // Queue the next turn, called before every tick
+} controller_t;
+
 typedef struct {
     void (*init)(void);
     void (*cleanup)(void);
     void (*clear_screen)(void);
     void (*draw_border)(int width, int height, int offset_x, int offset_y);
     void (*draw_text)(int x, int y, const char* text, int color_pair);
+    void (*draw_char)(int x, int y, char ch, int color_pair);
+    void (*get_size)(int* width, int* height);
     void (*refresh)(void);
+    int (*read_key)(void);          // Next pending key, ERR (-1) when none; may be NULL
 } renderer_t;
 
 // Level configuration
@@ -66,25 +94,53 @@ struct game {
 
     snake_t* snake;
     food_t* food;
+    grid_t* grid;           // Occupancy grid for O(1) collision queries
+    arena_t* arena;         // Memory of the current game, rewound at every level start
 
     int score;
     int high_score;
     int level;
 
+    // Per-game random generator, reseeded at every level start
+    rng_t rng;
+    uint64_t seed;          // Seed of the current game
+    uint64_t next_seed;     // Seed the next game will use
+
     int board_width;
     int board_height;
     int board_offset_x;
     int board_offset_y;
+    bool board_fixed;       // Board size set explicitly, ignore the terminal
+
+    // Input log, see replay.h
+    long tick_count;                // Ticks run in the current game
+    long food_tick;                 // Tick of the last apple eaten, 0 before the first
+    bool won;                       // The snake filled the whole board
+    replay_recorder_t* recorder;    // Records turns when not NULL
+    replay_player_t* player;        // Replays a recorded log when not NULL
+
+    // Computer player
+    controller_t* controller;       // Steers the snake when not NULL
+    autopilot_t* autopilot;         // Search buffers of the autopilot controller, in the arena
+    hamilton_t* hamilton;           // Cycle of the Hamiltonian controller, in the arena
+    mcts_t* mcts;                   // Search trees of the tree search controller, kept across games
+    bool mcts_unavailable;          // The board is too big for the tree search, use the autopilot
+    distance_field_t* food_distance; // Distances to the food for the greedy controller, in the arena
 
     state_handler_t* current_handler;
     level_config_t* level_config;
     renderer_t* renderer;
+    frame_stats_t* frame_stats;     // Per-frame timings of the interactive loop, may be NULL
+    unsigned int render_dirty;      // RENDER_DIRTY_* reasons to render, cleared by the loop
 
     bool running;
     bool paused;
 
     // Menu state
     int selected_level;
+
+    // Command line options
+    options_t options;
 };
 
 // Game management functions
@@ -93,19 +149,31 @@ void game_destroy(game_t* game);
 void game_init(game_t* game);
 void game_run(game_t* game);
 void game_update(game_t* game);
+bool game_tick(game_t* game);
 void game_render(game_t* game);
 void game_handle_input(game_t* game, int key);
 
 // State management
 void game_set_state(game_t* game, game_state_t new_state);
+void game_mark_dirty(game_t* game, unsigned int reasons);
 void game_change_level(game_t* game, int level);
+void game_set_seed(game_t* game, uint64_t seed);
 
 // Level configuration
 level_config_t* get_level_config(int level);
 int get_max_levels(void);
 
+// Computer players
+controller_t* get_bot_controller(bot_mode_t bot);
+
+// Board side limits in cells, border included. The largest board still
+// keeps the per-game arena around 100 MB and every cell index in an int.
+#define GAME_BOARD_MIN_SIZE     4
+#define GAME_BOARD_MAX_SIZE     1024
+
 // Game board utilities
 void game_calculate_board_size(game_t* game);
+void game_set_board_size(game_t* game, int width, int height);
 bool game_is_point_in_bounds(game_t* game, point_t p);
 bool game_is_point_on_border(game_t* game, point_t p);
 
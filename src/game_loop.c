@@ -0,0 +1,483 @@
+#define _POSIX_C_SOURCE 200809L
+#include "game.h"
+#include "scheduler.h"
+#include "score.h"
+#include "replay.h"
+#include "mcts.h"
+#include "frame_stats.h"
+#include "ansi.h"
+#include "ui.h"
+#include "input.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+// Longest time the loop sleeps before polling input again
+#define INPUT_POLL_INTERVAL_MS 10
+
+/******************************************************************************
+ * @brief 开始回放下一局录制的游戏
+ * 
+ * 没有更多对局时退出
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void game_replay_next(game_t* game) {
+    if (replay_player_begin_game(game->player, game)) {
+        game_set_state(game, STATE_PLAYING);
+    } else {
+        game_set_state(game, STATE_EXIT);
+    }
+}
+
+/******************************************************************************
+ * @brief 回放模式下的按键处理
+ * 
+ * 回放时不接受转向输入：Q/ESC 退出，P/空格 暂停，
+ * 游戏结束画面按任意键播放下一局
+ * 
+ * @param game 游戏实例指针
+ * @param key 按键值
+ *****************************************************************************/
+static void game_replay_handle_input(game_t* game, int key) {
+    if (key == 27 || key == 'q' || key == 'Q') {
+        game_set_state(game, STATE_EXIT);
+        return;
+    }
+
+    switch (game->state) {
+        case STATE_PLAYING:
+            if (key == 'p' || key == 'P' || key == ' ') {
+                game_set_state(game, STATE_PAUSED);
+            }
+            break;
+        case STATE_PAUSED:
+            if (key == 'p' || key == 'P' || key == ' ') {
+                game_set_state(game, STATE_PLAYING);
+            }
+            break;
+        case STATE_GAME_OVER:
+            game_replay_next(game);
+            break;
+        default:
+            break;
+    }
+}
+
+/******************************************************************************
+ * @brief 回放模式下执行一个节拍
+ * 
+ * 先应用录制的转向再更新游戏；录制的对局结束或蛇死亡时
+ * 校验两者是否一致，并切换到游戏结束画面
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void game_replay_update(game_t* game) {
+    if (replay_player_step(game->player, game) != REPLAY_CONTINUE) {
+        replay_player_check_end(game->player, game);
+        game_set_state(game, STATE_GAME_OVER);
+        return;
+    }
+
+    game_update(game);
+
+    if (game->next_state == STATE_GAME_OVER) {
+        replay_player_check_end(game->player, game);
+    }
+}
+
+/******************************************************************************
+ * @brief 切换帧耗时浮层
+ * 
+ * 关闭时整屏重绘以擦除浮层
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void game_toggle_frame_stats(game_t* game) {
+    if (!game->frame_stats) return;
+
+    game->frame_stats->overlay = !game->frame_stats->overlay;
+    if (!game->frame_stats->overlay) {
+        ui_invalidate();
+    }
+}
+
+/******************************************************************************
+ * @brief 初始化游戏系统
+ * 
+ * 设置随机种子、打开回放日志、初始化分数系统、渲染器，并设置初始状态处理器。
+ * 回放模式下直接开始第一局录制的游戏
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+void game_init(game_t* game) {
+    if (!game) return;
+
+    // Use the seed from the command line for reproducible runs
+    if (game->options.has_seed) {
+        game_set_seed(game, game->options.seed);
+    }
+
+    // Open the input log before touching the terminal so errors stay visible
+    if (game->options.record_path) {
+        game->recorder = replay_recorder_open(game->options.record_path);
+        if (!game->recorder) {
+            fprintf(stderr, "Cannot record to %s\n", game->options.record_path);
+            game->running = false;
+            return;
+        }
+    }
+
+    if (game->options.replay_path) {
+        game->player = replay_player_open(game->options.replay_path);
+        if (!game->player) {
+            fprintf(stderr, "Cannot replay %s\n", game->options.replay_path);
+            game->running = false;
+            return;
+        }
+    }
+
+    // Replays carry their own turns, a computer player would fight them
+    if (!game->player) {
+        game->controller = get_bot_controller(game->options.bot);
+    }
+
+    // Initialize score system
+    score_init(game);
+
+    // Frame timings are cheap enough to collect always; without them the
+    // overlay and the dump are simply unavailable
+    game->frame_stats = frame_stats_create();
+
+    // Set up renderer (from the options unless the caller chose one)
+    if (!game->renderer) {
+        game->renderer = game->options.renderer == RENDERER_ANSI ? get_ansi_renderer()
+                                                                 : get_ncurses_renderer();
+    }
+    ui_set_renderer(game->renderer);
+    if (game->renderer && game->renderer->init) {
+        game->renderer->init();
+    }
+
+    // Check if terminal size is adequate
+    if (!is_terminal_size_valid()) {
+        printf("Terminal too small! Minimum size: %dx%d\n",
+               MIN_TERMINAL_WIDTH, MIN_TERMINAL_HEIGHT);
+        game->running = false;
+        return;
+    }
+
+    // Calculate initial board size
+    game_calculate_board_size(game);
+
+    // Set initial state handler
+    game->current_handler = get_start_screen_handler();
+    if (game->current_handler && game->current_handler->enter) {
+        game->current_handler->enter(game);
+    }
+
+    if (game->player) {
+        game_replay_next(game);
+    }
+}
+
+/******************************************************************************
+ * @brief 创建事件循环使用的节拍定时器
+ * 
+ * @param game 游戏实例指针
+ * @return int timerfd 文件描述符，不使用事件循环或不支持时返回 -1
+ *****************************************************************************/
+static int game_create_tick_timer(game_t* game) {
+#ifdef __linux__
+    if (game->options.loop_mode == LOOP_EVENT) {
+        return timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    }
+#else
+    (void)game;
+#endif
+    return -1;
+}
+
+/******************************************************************************
+ * @brief 阻塞等待下一个事件
+ * 
+ * 将 timerfd 设置为下一个节拍的绝对截止时间，然后在标准输入和
+ * timerfd 上 poll()，直到有按键到达或节拍到期。没有待执行的节拍时
+ * （菜单、暂停、游戏结束）只等待按键，空闲时不占用 CPU。
+ * 被信号中断（如 SIGWINCH 终端尺寸变化）时直接返回
+ * 
+ * @param timer_fd 节拍定时器文件描述符
+ * @param deadline_ns 下一个节拍截止时间，-1 表示没有节拍
+ *****************************************************************************/
+static void game_wait_for_event(int timer_fd, int64_t deadline_ns) {
+#ifdef __linux__
+    struct itimerspec spec = {0};
+    if (deadline_ns >= 0) {
+        // A zero it_value would disarm the timer, so never pass 0
+        if (deadline_ns == 0) deadline_ns = 1;
+        spec.it_value.tv_sec = deadline_ns / 1000000000LL;
+        spec.it_value.tv_nsec = deadline_ns % 1000000000LL;
+    }
+    timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+
+    struct pollfd fds[2] = {
+        { .fd = STDIN_FILENO, .events = POLLIN },
+        { .fd = timer_fd, .events = POLLIN }
+    };
+
+    if (poll(fds, 2, -1) > 0 && (fds[1].revents & POLLIN)) {
+        uint64_t expirations;
+        if (read(timer_fd, &expirations, sizeof(expirations)) < 0) {
+            // Nothing to do: the scheduler tracks elapsed time itself
+        }
+    }
+#else
+    (void)timer_fd;
+    (void)deadline_ns;
+#endif
+}
+
+/******************************************************************************
+ * @brief 读取本进程累计写出的字节数和写系统调用次数
+ * 
+ * 来自 /proc/self/io 的 wchar 和 syscw，只在 Linux 上可用
+ * 
+ * @param bytes 输出参数 - 写出的字节数
+ * @param writes 输出参数 - write 类系统调用次数
+ * @return bool 读取成功返回 true
+ *****************************************************************************/
+static bool game_read_output_counters(long long* bytes, long long* writes) {
+    FILE* file = fopen("/proc/self/io", "r");
+    if (!file) return false;
+
+    char name[32];
+    long long value;
+    int found = 0;
+    while (fscanf(file, "%31[^:]: %lld\n", name, &value) == 2) {
+        if (strcmp(name, "wchar") == 0) {
+            *bytes = value;
+            found++;
+        } else if (strcmp(name, "syscw") == 0) {
+            *writes = value;
+            found++;
+        }
+    }
+    fclose(file);
+    return found == 2;
+}
+
+/******************************************************************************
+ * @brief 运行游戏主循环
+ * 
+ * 主循环流程:
+ * 1. 处理所有待处理的用户输入
+ * 2. 处理状态转换
+ * 3. 由单调时钟节拍调度器决定执行几次游戏逻辑更新
+ * 4. 画面有变化时渲染：按键、状态切换、游戏更新和终端尺寸变化会设置
+ *    脏标记（见 game_mark_dirty），两次渲染至少间隔 1/max_fps 秒。
+ *    开始、暂停和游戏结束画面因此只渲染一次，之后保持空闲
+ * 5. 记录本帧各阶段耗时和节拍延迟（见 frame_stats.h）
+ * 6. 等待下一个事件（下一个节拍，或被帧率上限推迟的渲染）：
+ *    - event 模式：在标准输入和节拍 timerfd 上阻塞 poll()
+ *    - sleep 模式：休眠到下一个截止时间（最长 INPUT_POLL_INTERVAL_MS）
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+void game_run(game_t* game) {
+    if (!game) return;
+
+    scheduler_t scheduler;
+    scheduler_init(&scheduler, SCHEDULER_MAX_CATCHUP);
+
+    int timer_fd = game_create_tick_timer(game);
+
+    // Terminal output per rendered frame, reported with the frame stats
+    long long start_bytes = 0, start_writes = 0;
+    bool output_counted = game->options.frame_stats_path &&
+                          game_read_output_counters(&start_bytes, &start_writes);
+    long rendered_frames = 0;
+    long iterations = 0;
+
+    // Render only when the screen is dirty, at most max_fps times a second
+    int64_t frame_interval_ns = game->options.max_fps > 0 ? 1000000000LL / game->options.max_fps : 0;
+    int64_t next_render_ns = 0;
+    int term_width, term_height;
+    ui_get_size(&term_width, &term_height);
+
+    while (game->running) {
+        iterations++;
+        frame_sample_t frame = {0};
+        frame.start_ns = time_now_ns();
+
+        // Handle all pending input
+        int key;
+        while ((key = ui_read_key()) != ERR) {
+            game_mark_dirty(game, RENDER_DIRTY_INPUT);
+            if (key == 'f' || key == 'F') {
+                game_toggle_frame_stats(game);
+            } else if (game->player) {
+                game_replay_handle_input(game, key);
+            } else {
+                game_handle_input(game, key);
+            }
+        }
+
+        // The renderer may only report a resize through its size
+        int width, height;
+        ui_get_size(&width, &height);
+        if (width != term_width || height != term_height) {
+            term_width = width;
+            term_height = height;
+            game_mark_dirty(game, RENDER_DIRTY_RESIZE);
+        }
+
+        // Handle state transitions
+        if (game->state != game->next_state) {
+            if (game->current_handler && game->current_handler->exit) {
+                game->current_handler->exit(game);
+            }
+
+            game->state = game->next_state;
+
+            switch (game->state) {
+                case STATE_START_SCREEN:
+                    game->current_handler = get_start_screen_handler();
+                    break;
+                case STATE_PLAYING:
+                    game->current_handler = get_game_screen_handler();
+                    break;
+                case STATE_GAME_OVER:
+                    game->current_handler = get_game_over_handler();
+                    break;
+                case STATE_PAUSED:
+                    // Keep current handler but stop updating
+                    break;
+                case STATE_EXIT:
+                    game->running = false;
+                    continue;
+            }
+
+            if (game->current_handler && game->current_handler->enter) {
+                game->current_handler->enter(game);
+            }
+            // The frame that requested the change may already have rendered
+            game_mark_dirty(game, RENDER_DIRTY_STATE);
+
+            // Ticks only accrue while playing; restart the clock on (re)entry
+            if (game->state == STATE_PLAYING) {
+                int speed_delay = game->level_config ? game->level_config->speed_delay : 200;
+                if (game->player) {
+                    speed_delay = (int)(speed_delay / game->options.replay_speed);
+                    if (speed_delay < 1) speed_delay = 1;
+                }
+                scheduler_start(&scheduler, speed_delay, time_now_ns());
+            } else {
+                scheduler_stop(&scheduler);
+            }
+        }
+
+        int64_t input_end = time_now_ns();
+
+        // Run the simulation ticks that are due
+        if (game->state == STATE_PLAYING && !game->paused) {
+            int ticks = scheduler_advance(&scheduler, input_end);
+            for (int i = 0; i < ticks && game->state == game->next_state; i++) {
+                if (game->player) {
+                    game_replay_update(game);
+                } else {
+                    game_update(game);
+                }
+                frame.ticks++;
+            }
+        }
+
+        int64_t update_end = time_now_ns();
+
+        // Render what changed, unless the frame cap holds it back
+        if (game->render_dirty && update_end >= next_render_ns) {
+            game->render_dirty = 0;
+            game_render(game);
+            rendered_frames++;
+            next_render_ns = update_end + frame_interval_ns;
+        }
+
+        int64_t render_end = time_now_ns();
+        int64_t refresh = ui_take_refresh_ns();
+        frame.phase_ns[FRAME_PHASE_FRAME] = render_end - frame.start_ns;
+        frame.phase_ns[FRAME_PHASE_INPUT] = input_end - frame.start_ns;
+        frame.phase_ns[FRAME_PHASE_UPDATE] = update_end - input_end;
+        frame.phase_ns[FRAME_PHASE_RENDER] = render_end - update_end - refresh;
+        frame.phase_ns[FRAME_PHASE_REFRESH] = refresh;
+        frame.phase_ns[FRAME_PHASE_SLIP] = frame.ticks > 0 ? scheduler.last_slip_ns : 0;
+        frame_stats_record(game->frame_stats, &frame);
+
+        if (!game->running || game->state != game->next_state) {
+            continue;
+        }
+
+        int64_t deadline = scheduler_next_deadline(&scheduler);
+        if (game->render_dirty && (deadline < 0 || next_render_ns < deadline)) {
+            deadline = next_render_ns;
+        }
+        if (timer_fd >= 0) {
+            // Block until a key arrives or the next tick is due
+            game_wait_for_event(timer_fd, deadline);
+        } else {
+            // Sleep until the next deadline, but wake up to poll input
+            int64_t wake_time = time_now_ns() + INPUT_POLL_INTERVAL_MS * 1000000LL;
+            if (deadline >= 0 && deadline < wake_time) {
+                wake_time = deadline;
+            }
+            sleep_until_ns(wake_time);
+        }
+    }
+
+    if (timer_fd >= 0) {
+        close(timer_fd);
+    }
+
+    long long end_bytes, end_writes;
+    output_counted = output_counted && rendered_frames > 0 &&
+                     game_read_output_counters(&end_bytes, &end_writes);
+
+    // Cleanup
+    if (game->renderer && game->renderer->cleanup) {
+        game->renderer->cleanup();
+    }
+
+    // Let the background writer finish a pending high score
+    score_shutdown();
+
+    if (game->options.frame_stats_path &&
+        !frame_stats_dump(game->frame_stats, game->options.frame_stats_path)) {
+        fprintf(stderr, "Cannot write frame stats to %s\n", game->options.frame_stats_path);
+    }
+    if (output_counted) {
+        fprintf(stderr, "Terminal output: %.1f bytes/frame, %.3f write calls/frame "
+                "over %ld rendered frames (%ld loop iterations)\n",
+                (double)(end_bytes - start_bytes) / rendered_frames,
+                (double)(end_writes - start_writes) / rendered_frames,
+                rendered_frames, iterations);
+    }
+
+    if (game->player && game->player->mismatches > 0) {
+        fprintf(stderr, "Replay diverged from the recording in %ld of %ld games\n",
+                game->player->mismatches, game->player->games);
+    }
+
+    if (game->mcts && game->mcts->search_ns > 0) {
+        fprintf(stderr, "Tree search: %ld rollouts, %.0f rollouts/sec, %d threads\n",
+                game->mcts->total_rollouts,
+                game->mcts->total_rollouts / (game->mcts->search_ns / 1e9), game->mcts->threads);
+        if (game->mcts->table_probes > 0) {
+            fprintf(stderr, "Transposition table: %.1f%% of %ld leaves reused a stored value\n",
+                    100.0 * game->mcts->table_hits / game->mcts->table_probes,
+                    game->mcts->table_probes);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "greedy.h"
+#include "autopilot.h"
+#include "distance_field.h"
+#include "snake.h"
+#include "food.h"
+#include "grid.h"
+#include <limits.h>
+
+static void greedy_reset(game_t* game);
+static void greedy_steer(game_t* game);
+
+// Static controller instance
+static controller_t greedy_controller = {
+    .name = "Greedy",
+    .reset = greedy_reset,
+    .steer = greedy_steer
+};
+
+/******************************************************************************
+ * @brief 新一局开始时准备距离场并关联到网格
+ * 
+ * 距离场从本局内存池分配，同时准备作为后备的自动驾驶缓冲区
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void greedy_reset(game_t* game) {
+    if (!game || !game->grid) return;
+
+    get_autopilot_controller()->reset(game);
+
+    distance_field_t* field = game->food_distance;
+    if (!field || field->width != game->grid->width || field->height != game->grid->height) {
+        distance_field_destroy(field);
+        field = distance_field_create(game->grid->width, game->grid->height, game->arena);
+        game->food_distance = field;
+    }
+
+    grid_attach_distance_field(game->grid, field);
+}
+
+/******************************************************************************
+ * @brief 贪心控制器：每个节拍前选择方向
+ * 
+ * 相邻空格子中，可达区域能容下整条蛇的按到食物的距离取最近；
+ * 都容不下时取可达区域最大的。找不到距离场或没有空邻居时交给自动驾驶。
+ * 太久没有吃到食物时认为在原地绕圈，由自动驾驶接管到吃到下一个食物
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void greedy_steer(game_t* game) {
+    if (!game || !game->snake || !game->grid) return;
+
+    long loop_ticks = GREEDY_LOOP_TICKS_PER_CELL * (long)game->grid->width * game->grid->height;
+    if (game->tick_count - game->food_tick > loop_ticks) {
+        get_autopilot_controller()->steer(game);
+        return;
+    }
+
+    if (!game->food_distance || game->grid->distances != game->food_distance) {
+        greedy_reset(game);
+    }
+
+    distance_field_t* field = game->food_distance;
+    if (!field) {
+        get_autopilot_controller()->steer(game);
+        return;
+    }
+
+    snake_t* snake = game->snake;
+    int food = game->food && game->food->active ?
+               grid_cell_index(game->grid, game->food->position) : -1;
+    distance_field_set_target(field, food);
+
+    point_t head = snake_get_head_position(snake);
+    direction_t back = opposite_direction(snake->direction);
+    int needed = snake->length + (snake->should_grow ? 1 : 0);
+    bool found = false;
+    bool best_safe = false;
+    int best_distance = INT_MAX;
+    int best_area = -1;
+    direction_t best_dir = snake->direction;
+
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        if (snake->length > 1 && d == (int)back) continue;
+
+        point_t next = point_add(head, direction_to_point((direction_t)d));
+        if (game_is_point_on_border(game, next) || grid_is_occupied(game->grid, next)) continue;
+
+        int area = grid_reachable_area(game->grid, next);
+        int distance = distance_field_get(field, grid_cell_index(game->grid, next));
+        if (distance == DISTANCE_FIELD_UNREACHABLE) distance = INT_MAX;
+        bool safe = area >= needed;
+
+        bool better = !found ||
+                      (safe && !best_safe) ||
+                      (safe && best_safe && distance < best_distance) ||
+                      (!safe && !best_safe && area > best_area);
+        if (better) {
+            found = true;
+            best_safe = safe;
+            best_distance = distance;
+            best_area = area;
+            best_dir = (direction_t)d;
+        }
+    }
+
+    if (!found) {
+        get_autopilot_controller()->steer(game);
+        return;
+    }
+
+    snake_clear_turns(snake);
+    snake_set_direction(snake, best_dir);
+}
+
+/******************************************************************************
+ * @brief 获取贪心控制器
+ * 
+ * @return controller_t* 控制器指针
+ *****************************************************************************/
+controller_t* get_greedy_controller(void) {
+    return &greedy_controller;
+}
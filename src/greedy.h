@@ -0,0 +1,19 @@
+#ifndef GREEDY_H
+#define GREEDY_H
+
+#include "game.h"
+
+// Greedy controller: steps onto the free neighbour closest to the food,
+// read from the distance field the grid keeps up to date, as long as the
+// area reachable from that neighbour can still hold the snake. When no
+// neighbour passes that check it heads for the largest reachable area.
+// Cheap per tick on any board size, but it can still box itself in.
+//
+// When the food only fits in an area too small for the snake, the greedy
+// choice can circle around it forever. After this many ticks per board
+// cell without eating, the autopilot steers until the next apple.
+#define GREEDY_LOOP_TICKS_PER_CELL  1
+
+controller_t* get_greedy_controller(void);
+
+#endif // GREEDY_H
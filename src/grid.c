@@ -0,0 +1,283 @@
+#include "grid.h"
+#include "distance_field.h"
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * @brief 检查网格下标是否为棋盘内部格子（不在边框上）
+ * 
+ * @param grid 网格实例指针
+ * @param index 网格下标
+ * @return bool 内部格子返回 true，否则返回 false
+ *****************************************************************************/
+static bool grid_is_interior(grid_t* grid, int index) {
+    int x = index % grid->width;
+    int y = index / grid->width;
+    return x > 0 && x < grid->width - 1 && y > 0 && y < grid->height - 1;
+}
+
+/******************************************************************************
+ * @brief 将格子加入空闲格子数组末尾
+ * 
+ * @param grid 网格实例指针
+ * @param index 网格下标
+ *****************************************************************************/
+static void grid_free_list_push(grid_t* grid, int index) {
+    grid->free_slots[index] = grid->free_count;
+    grid->free_cells[grid->free_count++] = index;
+}
+
+/******************************************************************************
+ * @brief 从空闲格子数组中移除格子
+ * 
+ * 用数组末尾元素填补被移除的位置（swap-remove），O(1)
+ * 
+ * @param grid 网格实例指针
+ * @param index 网格下标
+ *****************************************************************************/
+static void grid_free_list_remove(grid_t* grid, int index) {
+    int slot = grid->free_slots[index];
+    if (slot < 0) return;
+
+    int last = grid->free_cells[--grid->free_count];
+    grid->free_cells[slot] = last;
+    grid->free_slots[last] = slot;
+    grid->free_slots[index] = -1;
+}
+
+/******************************************************************************
+ * @brief 创建占用网格
+ * 
+ * 按棋盘尺寸分配网格，每个格子一个字节记录被蛇身占用的次数，
+ * 同时分配对应的位棋盘
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param offset_x 棋盘 X 偏移量
+ * @param offset_y 棋盘 Y 偏移量
+ * @param arena 内存池，NULL 表示从堆上分配
+ * @return grid_t* 网格实例指针，失败返回 NULL
+ *****************************************************************************/
+grid_t* grid_create(int width, int height, int offset_x, int offset_y, arena_t* arena) {
+    if (width < 1 || height < 1) return NULL;
+
+    grid_t* grid = arena_alloc(arena, sizeof(grid_t));
+    if (!grid) return NULL;
+
+    size_t cell_count = (size_t)width * height;
+    grid->arena = arena;
+    grid->cells = arena_calloc(arena, cell_count, sizeof(unsigned char));
+    grid->free_cells = arena_alloc(arena, sizeof(int) * cell_count);
+    grid->free_slots = arena_alloc(arena, sizeof(int) * cell_count);
+    grid->bits = bitboard_create(width, height, arena);
+    if (!grid->cells || !grid->free_cells || !grid->free_slots || !grid->bits) {
+        grid_destroy(grid);
+        return NULL;
+    }
+
+    grid->width = width;
+    grid->height = height;
+    grid->offset_x = offset_x;
+    grid->offset_y = offset_y;
+    grid->distances = NULL;
+    grid_clear(grid);
+
+    return grid;
+}
+
+/******************************************************************************
+ * @brief 销毁占用网格
+ * 
+ * @param grid 网格实例指针
+ *****************************************************************************/
+void grid_destroy(grid_t* grid) {
+    if (!grid) return;
+
+    arena_free(grid->arena, grid->cells);
+    arena_free(grid->arena, grid->free_cells);
+    arena_free(grid->arena, grid->free_slots);
+    bitboard_destroy(grid->bits);
+    arena_free(grid->arena, grid);
+}
+
+/******************************************************************************
+ * @brief 清空网格，将所有格子标记为空闲
+ * 
+ * 同时重建空闲格子索引，包含所有内部格子，位棋盘和距离场只保留边框
+ * 
+ * @param grid 网格实例指针
+ *****************************************************************************/
+void grid_clear(grid_t* grid) {
+    if (!grid) return;
+
+    int cell_count = grid->width * grid->height;
+    memset(grid->cells, 0, (size_t)cell_count);
+    bitboard_clear(grid->bits);
+    distance_field_clear(grid->distances);
+
+    grid->free_count = 0;
+    for (int i = 0; i < cell_count; i++) {
+        grid->free_slots[i] = -1;
+        if (grid_is_interior(grid, i)) {
+            grid_free_list_push(grid, i);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 将屏幕坐标转换为网格下标
+ * 
+ * @param grid 网格实例指针
+ * @param position 屏幕坐标
+ * @return int 网格下标，超出棋盘返回 -1
+ *****************************************************************************/
+int grid_cell_index(grid_t* grid, point_t position) {
+    if (!grid) return -1;
+
+    int x = position.x - grid->offset_x;
+    int y = position.y - grid->offset_y;
+    if (x < 0 || x >= grid->width || y < 0 || y >= grid->height) {
+        return -1;
+    }
+
+    return y * grid->width + x;
+}
+
+/******************************************************************************
+ * @brief 标记格子被一个蛇身段占用
+ * 
+ * @param grid 网格实例指针
+ * @param position 被占用的位置
+ *****************************************************************************/
+void grid_occupy(grid_t* grid, point_t position) {
+    int index = grid_cell_index(grid, position);
+    if (index < 0) return;
+
+    if (grid->cells[index]++ == 0) {
+        grid_free_list_remove(grid, index);
+        bitboard_set(grid->bits, index % grid->width, index / grid->width);
+        distance_field_block(grid->distances, index);
+    }
+}
+
+/******************************************************************************
+ * @brief 释放格子上的一个蛇身段占用
+ * 
+ * @param grid 网格实例指针
+ * @param position 被释放的位置
+ *****************************************************************************/
+void grid_vacate(grid_t* grid, point_t position) {
+    int index = grid_cell_index(grid, position);
+    if (index < 0 || grid->cells[index] == 0) return;
+
+    if (--grid->cells[index] == 0 && grid_is_interior(grid, index)) {
+        grid_free_list_push(grid, index);
+        bitboard_reset(grid->bits, index % grid->width, index / grid->width);
+        distance_field_unblock(grid->distances, index);
+    }
+}
+
+/******************************************************************************
+ * @brief 关联距离场，之后每次占用和释放格子都会通知它
+ * 
+ * 关联时按当前占用情况重建距离场的阻挡格子。距离场尺寸必须与网格一致，
+ * 否则不关联
+ * 
+ * @param grid 网格实例指针
+ * @param field 距离场指针，NULL 表示取消关联
+ *****************************************************************************/
+void grid_attach_distance_field(grid_t* grid, distance_field_t* field) {
+    if (!grid) return;
+
+    grid->distances = NULL;
+    if (!field || field->width != grid->width || field->height != grid->height) return;
+
+    distance_field_clear(field);
+    for (int i = 0; i < grid->width * grid->height; i++) {
+        if (grid->cells[i] > 0) {
+            distance_field_block(field, i);
+        }
+    }
+    grid->distances = field;
+}
+
+/******************************************************************************
+ * @brief 获取格子上的蛇身段数量
+ * 
+ * @param grid 网格实例指针
+ * @param position 要查询的位置
+ * @return int 占用次数，超出棋盘返回 0
+ *****************************************************************************/
+int grid_get_count(grid_t* grid, point_t position) {
+    int index = grid_cell_index(grid, position);
+    if (index < 0) return 0;
+
+    return grid->cells[index];
+}
+
+/******************************************************************************
+ * @brief 检查格子是否被占用（O(1)）
+ * 
+ * @param grid 网格实例指针
+ * @param position 要查询的位置
+ * @return bool 被占用返回 true，否则返回 false
+ *****************************************************************************/
+bool grid_is_occupied(grid_t* grid, point_t position) {
+    return grid_get_count(grid, position) > 0;
+}
+
+/******************************************************************************
+ * @brief 将网格下标转换为屏幕坐标
+ * 
+ * @param grid 网格实例指针
+ * @param index 网格下标
+ * @return point_t 屏幕坐标
+ *****************************************************************************/
+point_t grid_cell_position(grid_t* grid, int index) {
+    if (!grid) return point_create(0, 0);
+
+    return point_create(grid->offset_x + index % grid->width,
+                        grid->offset_y + index / grid->width);
+}
+
+/******************************************************************************
+ * @brief 获取空闲内部格子数量
+ * 
+ * @param grid 网格实例指针
+ * @return int 空闲格子数量
+ *****************************************************************************/
+int grid_free_count(grid_t* grid) {
+    return grid ? grid->free_count : 0;
+}
+
+/******************************************************************************
+ * @brief 获取空闲格子数组中指定槽位的格子坐标
+ * 
+ * 配合 [0, grid_free_count) 内的随机槽位可 O(1) 均匀选取空格子
+ * 
+ * @param grid 网格实例指针
+ * @param slot 槽位序号
+ * @return point_t 格子屏幕坐标，槽位无效返回 (0, 0)
+ *****************************************************************************/
+point_t grid_get_free_cell(grid_t* grid, int slot) {
+    if (!grid || slot < 0 || slot >= grid->free_count) {
+        return point_create(0, 0);
+    }
+    return grid_cell_position(grid, grid->free_cells[slot]);
+}
+
+/******************************************************************************
+ * @brief 统计从指定位置出发可到达的空闲格子数量
+ * 
+ * 在位棋盘上做泛洪填充；位置本身被占用时（例如蛇头）从它的空闲邻居开始
+ * 
+ * @param grid 网格实例指针
+ * @param position 起点屏幕坐标
+ * @return int 可达的空闲格子数量，超出棋盘返回 0
+ *****************************************************************************/
+int grid_reachable_area(grid_t* grid, point_t position) {
+    int index = grid_cell_index(grid, position);
+    if (index < 0) return 0;
+
+    return bitboard_flood_fill(grid->bits, index % grid->width, index / grid->width);
+}
@@ -0,0 +1,58 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include "game.h"
+#include "bitboard.h"
+#include "arena.h"
+#include "utils.h"
+#include <stdbool.h>
+
+// Occupancy grid covering the whole game board (border included).
+// Each cell stores how many snake segments currently sit on it, so a
+// value above 1 means the snake overlaps itself.
+//
+// Empty interior cells are additionally kept in a dense array with a
+// cell-to-slot map, maintained by swap-remove, so a random empty cell can
+// be picked in constant time however crowded the board is.
+//
+// The bitboard mirrors the walls and every occupied cell one bit per cell,
+// for word-parallel reachability queries. An attached distance field is
+// told about every cell that becomes occupied or free.
+struct grid {
+    int width;
+    int height;
+    int offset_x;
+    int offset_y;
+    unsigned char* cells;
+    int* free_cells;        // Dense array of empty interior cell indices
+    int* free_slots;        // Cell index -> slot in free_cells, -1 if absent
+    int free_count;
+    bitboard_t* bits;       // Walls and snake body, one bit per cell
+    distance_field_t* distances; // Kept in sync when attached, not owned
+    arena_t* arena;         // Owner of the memory, NULL for the heap
+};
+
+// Grid creation and destruction
+grid_t* grid_create(int width, int height, int offset_x, int offset_y, arena_t* arena);
+void grid_destroy(grid_t* grid);
+
+// Grid operations
+void grid_clear(grid_t* grid);
+void grid_occupy(grid_t* grid, point_t position);
+void grid_vacate(grid_t* grid, point_t position);
+void grid_attach_distance_field(grid_t* grid, distance_field_t* field);
+
+// Grid queries
+int grid_cell_index(grid_t* grid, point_t position);
+int grid_get_count(grid_t* grid, point_t position);
+bool grid_is_occupied(grid_t* grid, point_t position);
+point_t grid_cell_position(grid_t* grid, int index);
+
+// Free cell index
+int grid_free_count(grid_t* grid);
+point_t grid_get_free_cell(grid_t* grid, int slot);
+
+// Reachability
+int grid_reachable_area(grid_t* grid, point_t position);
+
+#endif // GRID_H
@@ -0,0 +1,235 @@
+#include "hamilton.h"
+#include "autopilot.h"
+#include "snake.h"
+#include "food.h"
+#include "grid.h"
+#include <stdlib.h>
+
+static void hamilton_reset(game_t* game);
+static void hamilton_steer(game_t* game);
+
+// Static controller instance
+static controller_t hamilton_controller = {
+    .name = "Hamiltonian",
+    .reset = hamilton_reset,
+    .steer = hamilton_steer
+};
+
+/******************************************************************************
+ * @brief 生成棋盘内部的哈密顿回路
+ * 
+ * 内部高度为偶数时：第 0 列留作回程，其余列按行蛇形遍历，最后沿第 0 列返回；
+ * 否则宽度为偶数，行列互换。内部格子数为奇数时不存在回路
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param arena 内存池，NULL 表示从堆上分配
+ * @return hamilton_t* 回路指针，失败返回 NULL
+ *****************************************************************************/
+hamilton_t* hamilton_create(int width, int height, arena_t* arena) {
+    if (width < 3 || height < 3) return NULL;
+
+    hamilton_t* hamilton = arena_alloc(arena, sizeof(hamilton_t));
+    if (!hamilton) return NULL;
+
+    hamilton->arena = arena;
+    hamilton->order = arena_alloc(arena, sizeof(int) * width * height);
+    if (!hamilton->order) {
+        arena_free(arena, hamilton);
+        return NULL;
+    }
+
+    int inner_width = width - 2;
+    int inner_height = height - 2;
+    hamilton->width = width;
+    hamilton->height = height;
+    hamilton->cycle_length = inner_width * inner_height;
+    hamilton->valid = inner_width >= 2 && inner_height >= 2 &&
+                      hamilton->cycle_length % 2 == 0;
+
+    for (int i = 0; i < width * height; i++) {
+        hamilton->order[i] = -1;
+    }
+    if (!hamilton->valid) return hamilton;
+
+    // Lay the cycle out with rows as the serpentine lanes; on boards with an
+    // odd interior height use columns instead
+    bool by_rows = inner_height % 2 == 0;
+    int lanes = by_rows ? inner_height : inner_width;
+    int lane_length = by_rows ? inner_width : inner_height;
+    int n = 0;
+
+    for (int lane = 0; lane < lanes; lane++) {
+        for (int k = 1; k < lane_length; k++) {
+            int along = lane % 2 == 0 ? k : lane_length - k;
+            int x = by_rows ? along : lane;
+            int y = by_rows ? lane : along;
+            hamilton->order[(y + 1) * width + x + 1] = n++;
+        }
+    }
+    for (int lane = lanes - 1; lane >= 0; lane--) {
+        int x = by_rows ? 0 : lane;
+        int y = by_rows ? lane : 0;
+        hamilton->order[(y + 1) * width + x + 1] = n++;
+    }
+
+    return hamilton;
+}
+
+/******************************************************************************
+ * @brief 销毁哈密顿回路
+ * 
+ * @param hamilton 回路指针
+ *****************************************************************************/
+void hamilton_destroy(hamilton_t* hamilton) {
+    if (!hamilton) return;
+
+    arena_free(hamilton->arena, hamilton->order);
+    arena_free(hamilton->arena, hamilton);
+}
+
+/******************************************************************************
+ * @brief 沿回路从位置 from 前进到位置 to 的步数
+ * 
+ * @param hamilton 回路指针
+ * @param from 起点的回路位置
+ * @param to 终点的回路位置
+ * @return int 步数
+ *****************************************************************************/
+static inline int hamilton_distance(const hamilton_t* hamilton, int from, int to) {
+    int distance = to - from;
+    return distance < 0 ? distance + hamilton->cycle_length : distance;
+}
+
+/******************************************************************************
+ * @brief 为下一个节拍选择方向（O(1)）
+ * 
+ * 默认沿回路走到下一个位置。如果相邻格子在回路上位于蛇头之前、
+ * 蛇尾之后的空闲区间内（留出生长和安全余量），可以直接跳过去，
+ * 选择不越过食物的最远的一个。蛇占据超过一半棋盘后只沿回路走，
+ * 保证最终填满整个棋盘
+ * 
+ * @param hamilton 回路指针（必须与棋盘尺寸一致且有效）
+ * @param game 游戏实例指针
+ * @param dir 输出方向
+ * @return bool 找到方向返回 true
+ *****************************************************************************/
+bool hamilton_choose_direction(hamilton_t* hamilton, game_t* game, direction_t* dir) {
+    if (!hamilton || !hamilton->valid || !game || !game->snake || !game->grid || !dir) {
+        return false;
+    }
+
+    snake_t* snake = game->snake;
+    int head_cell = grid_cell_index(game->grid, snake_get_head_position(snake));
+    if (head_cell < 0) return false;
+    int head = hamilton->order[head_cell];
+    if (head < 0) return false;
+
+    // Furthest the head may jump ahead without reaching the tail. A lone
+    // head that is not about to grow may go anywhere but one step back
+    // along the cycle, which would leave the next cell behind its neck.
+    int available;
+    if (snake->length == 1 && !snake->should_grow) {
+        available = hamilton->cycle_length - 2;
+    } else if (snake->length * 100 >= hamilton->cycle_length * HAMILTON_SHORTCUT_MAX_FILL) {
+        available = 1;
+    } else {
+        int gap = hamilton->cycle_length;
+        if (snake->length > 1) {
+            int tail_cell = grid_cell_index(game->grid, snake_get_tail_position(snake));
+            gap = hamilton_distance(hamilton, head, hamilton->order[tail_cell]);
+        }
+        available = gap - HAMILTON_SHORTCUT_MARGIN - (snake->should_grow ? 1 : 0);
+    }
+
+    // Do not jump past the food
+    int target = hamilton->cycle_length;
+    if (game->food && game->food->active) {
+        int food_cell = grid_cell_index(game->grid, game->food->position);
+        if (food_cell >= 0 && hamilton->order[food_cell] >= 0) {
+            target = hamilton_distance(hamilton, head, hamilton->order[food_cell]);
+        }
+    }
+
+    direction_t back = opposite_direction(snake->direction);
+    int best = 0;
+    int fallback = 0;
+
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        if (d == (int)back) continue;
+
+        point_t step = direction_to_point((direction_t)d);
+        int next = hamilton->order[head_cell + step.y * hamilton->width + step.x];
+        if (next < 0) continue;
+
+        // The next cell on the cycle is always safe; others must fit the gap
+        int distance = hamilton_distance(hamilton, head, next);
+        if (distance != 1 && distance > available) continue;
+
+        if (distance <= target && distance > best) {
+            best = distance;
+            *dir = (direction_t)d;
+        } else if (best == 0 && (fallback == 0 || distance < fallback)) {
+            fallback = distance;
+            *dir = (direction_t)d;
+        }
+    }
+
+    return best > 0 || fallback > 0;
+}
+
+/******************************************************************************
+ * @brief 新一局开始时在本局内存池中预先计算回路
+ * 
+ * 同时准备作为后备的自动驾驶缓冲区
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void hamilton_reset(game_t* game) {
+    if (!game || !game->grid) return;
+
+    get_autopilot_controller()->reset(game);
+
+    hamilton_t* hamilton = game->hamilton;
+    if (hamilton && hamilton->width == game->grid->width &&
+        hamilton->height == game->grid->height) {
+        return;
+    }
+
+    hamilton_destroy(hamilton);
+    game->hamilton = hamilton_create(game->grid->width, game->grid->height, game->arena);
+}
+
+/******************************************************************************
+ * @brief 哈密顿回路控制器：每个节拍前选择方向
+ * 
+ * 不存在回路的棋盘（内部格子数为奇数）或没有可走的回路方向时交给自动驾驶
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void hamilton_steer(game_t* game) {
+    if (!game || !game->snake) return;
+
+    if (!game->hamilton) {
+        hamilton_reset(game);
+    }
+
+    direction_t dir;
+    if (hamilton_choose_direction(game->hamilton, game, &dir)) {
+        snake_clear_turns(game->snake);
+        snake_set_direction(game->snake, dir);
+        return;
+    }
+
+    controller_t* fallback = get_autopilot_controller();
+    fallback->steer(game);
+}
+
+/******************************************************************************
+ * @brief 获取哈密顿回路控制器
+ * 
+ * @return controller_t* 控制器指针
+ *****************************************************************************/
+controller_t* get_hamilton_controller(void) {
+    return &hamilton_controller;
+}
@@ -0,0 +1,45 @@
+#ifndef HAMILTON_H
+#define HAMILTON_H
+
+#include "game.h"
+#include "utils.h"
+#include "arena.h"
+#include <stdbool.h>
+
+// Stop taking shortcuts once the snake covers this share of the board
+// (in percent) and just follow the cycle until the board is full
+#define HAMILTON_SHORTCUT_MAX_FILL  50
+
+// Cells kept free between the head and the tail when cutting across. The
+// head can then only reach the tail if apples appear, one after another,
+// on each of these cells just as the head gets there; with 16 cells the
+// chance is below 1 in 10^13.
+#define HAMILTON_SHORTCUT_MARGIN    16
+
+// Hamiltonian cycle over the board interior. A cycle exists when the
+// interior has an even number of cells; on odd boards `valid` is false and
+// the controller falls back to the autopilot.
+//
+// While the snake's body lies in cycle order behind the head, every cell
+// ahead of the head and before the tail is free, so the head may jump
+// forward along the cycle to any neighbour in that range.
+struct hamilton {
+    int width;              // Board width including border
+    int height;             // Board height including border
+    int cycle_length;       // Interior cell count
+    int* order;             // Cycle position per grid cell, -1 on the border
+    bool valid;
+    arena_t* arena;         // Owner of the memory, NULL for the heap
+};
+
+// Cycle management
+hamilton_t* hamilton_create(int width, int height, arena_t* arena);
+void hamilton_destroy(hamilton_t* hamilton);
+
+// Decision
+bool hamilton_choose_direction(hamilton_t* hamilton, game_t* game, direction_t* dir);
+
+// Controller following the cycle with shortcuts
+controller_t* get_hamilton_controller(void);
+
+#endif // HAMILTON_H
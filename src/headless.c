@@ -0,0 +1,119 @@
+#include "headless.h"
+#include <stddef.h>
+
+// Virtual screen size reported to the UI
+static int headless_width = 80;
+static int headless_height = 24;
+
+// Number of drawing calls received, lets benchmarks keep the work observable
+static long headless_draw_count = 0;
+
+static void headless_init(void) {
+    headless_draw_count = 0;
+}
+
+static void headless_cleanup(void) {
+    // Nothing to release
+}
+
+static void headless_clear_screen(void) {
+    headless_draw_count++;
+}
+
+static void headless_draw_border(int width, int height, int offset_x, int offset_y) {
+    (void)offset_x;
+    (void)offset_y;
+    headless_draw_count += 2L * (width + height);
+}
+
+static void headless_draw_text(int x, int y, const char* text, int color_pair) {
+    (void)x;
+    (void)y;
+    (void)text;
+    (void)color_pair;
+    headless_draw_count++;
+}
+
+static void headless_draw_char(int x, int y, char ch, int color_pair) {
+    (void)x;
+    (void)y;
+    (void)ch;
+    (void)color_pair;
+    headless_draw_count++;
+}
+
+static void headless_get_size(int* width, int* height) {
+    *width = headless_width;
+    *height = headless_height;
+}
+
+static void headless_refresh(void) {
+    // Nothing to flush
+}
+
+static void headless_play_update(game_t* game) {
+    game_tick(game);
+}
+
+// Static renderer instance
+static renderer_t headless_renderer = {
+    .init = headless_init,
+    .cleanup = headless_cleanup,
+    .clear_screen = headless_clear_screen,
+    .draw_border = headless_draw_border,
+    .draw_text = headless_draw_text,
+    .draw_char = headless_draw_char,
+    .get_size = headless_get_size,
+    .refresh = headless_refresh
+};
+
+// Playing state without rendering or input
+static state_handler_t headless_play_handler = {
+    .update = headless_play_update,
+    .render = NULL,
+    .handle_input = NULL,
+    .enter = NULL,
+    .exit = NULL
+};
+
+/******************************************************************************
+ * @brief 获取无终端渲染器实例
+ * 
+ * 所有绘制调用只计数不输出，用于模拟、回放和基准测试
+ * 
+ * @return renderer_t* 无终端渲染器指针
+ *****************************************************************************/
+renderer_t* get_headless_renderer(void) {
+    return &headless_renderer;
+}
+
+/******************************************************************************
+ * @brief 设置无终端渲染器报告的虚拟屏幕尺寸
+ * 
+ * @param width 屏幕宽度（列数）
+ * @param height 屏幕高度（行数）
+ *****************************************************************************/
+void headless_set_size(int width, int height) {
+    headless_width = width;
+    headless_height = height;
+}
+
+/******************************************************************************
+ * @brief 获取无终端渲染器收到的绘制调用次数
+ * 
+ * @return long 绘制调用次数
+ *****************************************************************************/
+long headless_get_draw_count(void) {
+    return headless_draw_count;
+}
+
+/******************************************************************************
+ * @brief 获取无终端游戏状态处理器
+ * 
+ * update 执行 game_tick，不渲染也不处理输入
+ * 
+ * @return state_handler_t* 无终端游戏状态处理器指针
+ *****************************************************************************/
+state_handler_t* get_headless_play_handler(void) {
+    return &headless_play_handler;
+}
@@ -0,0 +1,14 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "game.h"
+
+// Headless renderer: accepts every drawing call without a terminal
+renderer_t* get_headless_renderer(void);
+void headless_set_size(int width, int height);
+long headless_get_draw_count(void);
+
+// State handler that runs game ticks without rendering or input
+state_handler_t* get_headless_play_handler(void);
+
+#endif // HEADLESS_H
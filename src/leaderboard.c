@@ -0,0 +1,267 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE     // flock()
+#include "leaderboard.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LEADERBOARD_FILE_SIZE \
+    (sizeof(leaderboard_header_t) + \
+     sizeof(leaderboard_record_t) * LEADERBOARD_LEVELS * LEADERBOARD_ENTRIES)
+
+/******************************************************************************
+ * @brief 检查文件头是否与本程序的格式一致
+ *****************************************************************************/
+static bool leaderboard_header_valid(const leaderboard_header_t* header) {
+    if (memcmp(header->magic, LEADERBOARD_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != LEADERBOARD_VERSION ||
+        header->record_size != sizeof(leaderboard_record_t) ||
+        header->levels != LEADERBOARD_LEVELS ||
+        header->entries != LEADERBOARD_ENTRIES) {
+        return false;
+    }
+    for (int i = 0; i < LEADERBOARD_LEVELS; i++) {
+        if (header->counts[i] > LEADERBOARD_ENTRIES) return false;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief 打开（不存在时创建）排行榜文件并映射到内存
+ * 
+ * 在排他锁内检查文件：空文件（刚创建，或另一个进程创建后还没来得及
+ * 初始化）写入文件头；大小或文件头不符的文件不会被覆盖，返回 NULL
+ * 
+ * @param path 文件路径，所在目录不存在时创建
+ * @return leaderboard_t* 排行榜指针，失败返回 NULL
+ *****************************************************************************/
+leaderboard_t* leaderboard_open(const char* path) {
+    if (!path) return NULL;
+
+    make_parent_dir(path);
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return NULL;
+
+    if (flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    bool fresh = ok && info.st_size == 0;
+    if (fresh) {
+        ok = ftruncate(fd, (off_t)LEADERBOARD_FILE_SIZE) == 0;
+    } else if (ok) {
+        ok = (size_t)info.st_size == LEADERBOARD_FILE_SIZE;
+    }
+
+    void* map = MAP_FAILED;
+    if (ok) {
+        map = mmap(NULL, LEADERBOARD_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ok = map != MAP_FAILED;
+    }
+
+    leaderboard_header_t* header = ok ? map : NULL;
+    if (ok && fresh) {
+        memcpy(header->magic, LEADERBOARD_MAGIC, sizeof(header->magic));
+        header->version = LEADERBOARD_VERSION;
+        header->record_size = sizeof(leaderboard_record_t);
+        header->levels = LEADERBOARD_LEVELS;
+        header->entries = LEADERBOARD_ENTRIES;
+    }
+    ok = ok && leaderboard_header_valid(header);
+    flock(fd, LOCK_UN);
+
+    leaderboard_t* board = ok ? calloc(1, sizeof(leaderboard_t)) : NULL;
+    if (!board) {
+        if (map != MAP_FAILED) munmap(map, LEADERBOARD_FILE_SIZE);
+        close(fd);
+        return NULL;
+    }
+
+    board->fd = fd;
+    board->map = map;
+    board->size = LEADERBOARD_FILE_SIZE;
+    board->header = header;
+    board->records = (leaderboard_record_t*)(header + 1);
+    pthread_mutex_init(&board->lock, NULL);
+    return board;
+}
+
+/******************************************************************************
+ * @brief 解除映射并关闭排行榜文件
+ * 
+ * @param board 排行榜指针
+ *****************************************************************************/
+void leaderboard_close(leaderboard_t* board) {
+    if (!board) return;
+
+    munmap(board->map, board->size);
+    close(board->fd);
+    pthread_mutex_destroy(&board->lock);
+    free(board);
+}
+
+/******************************************************************************
+ * @brief 填写一条记录
+ * 
+ * 名字超长时截断，其余字节补零，使同样的对局得到逐字节相同的记录
+ * 
+ * @param record 输出记录
+ * @param name 玩家名字，NULL 时为空
+ * @param level 难度等级
+ * @param score 分数
+ * @param length 蛇长度
+ * @param duration_ms 对局时长（毫秒）
+ * @param seed 对局种子
+ *****************************************************************************/
+void leaderboard_record_init(leaderboard_record_t* record, const char* name, int level,
+                             int score, int length, int64_t duration_ms, uint64_t seed) {
+    if (!record) return;
+
+    memset(record, 0, sizeof(*record));
+    if (name) {
+        strncpy(record->name, name, LEADERBOARD_NAME_LENGTH - 1);
+    }
+    record->level = level;
+    record->score = score;
+    record->length = length;
+    record->duration_ms = duration_ms;
+    record->seed = seed;
+}
+
+/******************************************************************************
+ * @brief 提交一局的结果
+ * 
+ * 临界区只有一次二分查找式的插入：找到第一个分数更低的位置，
+ * 把后面的记录后移一格（挤掉末尾），写入新记录
+ * 
+ * @param board 排行榜指针
+ * @param record 记录
+ * @return int 在该等级中的名次（从 1 开始），未进入前 N 名或失败返回 0
+ *****************************************************************************/
+int leaderboard_submit(leaderboard_t* board, const leaderboard_record_t* record) {
+    if (!board || !record || record->level < 1 || record->level > LEADERBOARD_LEVELS) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&board->lock);
+    if (flock(board->fd, LOCK_EX) != 0) {
+        pthread_mutex_unlock(&board->lock);
+        return 0;
+    }
+
+    int level = record->level - 1;
+    leaderboard_record_t* records = board->records + level * LEADERBOARD_ENTRIES;
+    int count = (int)board->header->counts[level];
+
+    int low = 0, high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (records[mid].score >= record->score) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    int rank = 0;
+    if (low < LEADERBOARD_ENTRIES) {
+        int moved = (count < LEADERBOARD_ENTRIES ? count : LEADERBOARD_ENTRIES - 1) - low;
+        memmove(&records[low + 1], &records[low], sizeof(leaderboard_record_t) * moved);
+        records[low] = *record;
+        if (count < LEADERBOARD_ENTRIES) {
+            board->header->counts[level] = (uint32_t)(count + 1);
+        }
+        rank = low + 1;
+    }
+
+    flock(board->fd, LOCK_UN);
+    pthread_mutex_unlock(&board->lock);
+    return rank;
+}
+
+/******************************************************************************
+ * @brief 取得读锁并返回一个等级的记录
+ * 
+ * @param board 排行榜指针
+ * @param level 难度等级（从 1 开始）
+ * @param count 输出参数 - 记录数
+ * @param wait 锁被占用时是否等待
+ * @return const leaderboard_record_t* 记录，失败或（不等待时）锁被占用返回 NULL
+ *****************************************************************************/
+static const leaderboard_record_t* leaderboard_begin_read(leaderboard_t* board, int level,
+                                                         int* count, bool wait) {
+    *count = 0;
+    if (!board || level < 1 || level > LEADERBOARD_LEVELS) return NULL;
+
+    if (wait) {
+        pthread_mutex_lock(&board->lock);
+    } else if (pthread_mutex_trylock(&board->lock) != 0) {
+        return NULL;
+    }
+    if (flock(board->fd, wait ? LOCK_SH : LOCK_SH | LOCK_NB) != 0) {
+        pthread_mutex_unlock(&board->lock);
+        return NULL;
+    }
+
+    *count = (int)board->header->counts[level - 1];
+    return board->records + (level - 1) * LEADERBOARD_ENTRIES;
+}
+
+/******************************************************************************
+ * @brief 开始读取一个等级的记录（不复制）
+ * 
+ * 返回的指针直接指向映射，在 leaderboard_read_done 之前其他进程和
+ * 线程都不能修改。成功返回后必须调用 leaderboard_read_done
+ * 
+ * @param board 排行榜指针
+ * @param level 难度等级（从 1 开始）
+ * @param count 输出参数 - 记录数
+ * @return const leaderboard_record_t* 按分数降序排列的记录，失败返回 NULL
+ *****************************************************************************/
+const leaderboard_record_t* leaderboard_read_level(leaderboard_t* board, int level, int* count) {
+    return leaderboard_begin_read(board, level, count, true);
+}
+
+/******************************************************************************
+ * @brief 不等待地开始读取一个等级的记录
+ * 
+ * 与 leaderboard_read_level 相同，但本进程的其他线程或其他进程
+ * 正在修改时立即返回 NULL，供不能阻塞的渲染线程使用
+ * 
+ * @param board 排行榜指针
+ * @param level 难度等级（从 1 开始）
+ * @param count 输出参数 - 记录数
+ * @return const leaderboard_record_t* 按分数降序排列的记录，失败或正忙返回 NULL
+ *****************************************************************************/
+const leaderboard_record_t* leaderboard_try_read_level(leaderboard_t* board, int level,
+                                                       int* count) {
+    return leaderboard_begin_read(board, level, count, false);
+}
+
+/******************************************************************************
+ * @brief 结束读取，释放 leaderboard_read_level 取得的锁
+ * 
+ * @param board 排行榜指针
+ *****************************************************************************/
+void leaderboard_read_done(leaderboard_t* board) {
+    if (!board) return;
+
+    flock(board->fd, LOCK_UN);
+    pthread_mutex_unlock(&board->lock);
+}
+
+/******************************************************************************
+ * @brief 比较两条记录是否相同
+ * 
+ * @return bool 逐字节相同返回 true
+ *****************************************************************************/
+bool leaderboard_record_equals(const leaderboard_record_t* a, const leaderboard_record_t* b) {
+    return memcmp(a, b, sizeof(leaderboard_record_t)) == 0;
+}
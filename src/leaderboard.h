@@ -0,0 +1,71 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include "utils.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// File format, bump the version when the layout changes
+#define LEADERBOARD_MAGIC       "SNAKELB\0"
+#define LEADERBOARD_VERSION     1
+#define LEADERBOARD_LEVELS      MAX_LEVELS
+#define LEADERBOARD_ENTRIES     10      // Top N kept per level
+#define LEADERBOARD_NAME_LENGTH 16      // Including the terminating NUL
+
+// One finished game, 48 bytes, native byte order
+typedef struct {
+    char name[LEADERBOARD_NAME_LENGTH]; // Player name, NUL padded
+    int32_t level;
+    int32_t score;
+    int32_t length;         // Snake length at death
+    int32_t reserved;
+    int64_t duration_ms;    // Game time: ticks times the level's tick interval
+    uint64_t seed;          // Seed that replays the game's food
+} leaderboard_record_t;
+
+// File header, 64 bytes. The records of level L (1-based) follow it, at
+// index (L - 1) * entries, sorted by descending score; ties keep the
+// older record first.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t levels;
+    uint32_t entries;
+    uint32_t counts[LEADERBOARD_LEVELS];    // Records in use per level
+    uint32_t reserved[5];
+} leaderboard_header_t;
+
+// A leaderboard file mapped shared into this process. Every process that
+// opens the file sees the same pages, so a change is visible to all of
+// them as soon as it is made. Changes and reads take flock() on the file
+// (exclusive and shared) to exclude other processes, and `lock` to
+// exclude other threads of this one, which share the descriptor's flock.
+typedef struct {
+    int fd;
+    void* map;
+    size_t size;
+    leaderboard_header_t* header;
+    leaderboard_record_t* records;
+    pthread_mutex_t lock;
+} leaderboard_t;
+
+// File management
+leaderboard_t* leaderboard_open(const char* path);
+void leaderboard_close(leaderboard_t* board);
+
+// Updates
+void leaderboard_record_init(leaderboard_record_t* record, const char* name, int level,
+                             int score, int length, int64_t duration_ms, uint64_t seed);
+int leaderboard_submit(leaderboard_t* board, const leaderboard_record_t* record);
+
+// Zero-copy reads: the records point into the mapping until the unlock.
+// The try variant returns NULL instead of waiting while a writer holds it.
+const leaderboard_record_t* leaderboard_read_level(leaderboard_t* board, int level, int* count);
+const leaderboard_record_t* leaderboard_try_read_level(leaderboard_t* board, int level,
+                                                       int* count);
+void leaderboard_read_done(leaderboard_t* board);
+bool leaderboard_record_equals(const leaderboard_record_t* a, const leaderboard_record_t* b);
+
+#endif // LEADERBOARD_H
@@ -7,14 +7,25 @@
  * @brief 程序入口函数 - 初始化并运行贪吃蛇游戏
  * 
  * 主函数流程:
- * 1. 检查终端尺寸是否满足游戏要求
- * 2. 创建并初始化游戏实例
- * 3. 运行游戏主循环
- * 4. 清理资源并退出
+ * 1. 解析命令行参数
+ * 2. 检查终端尺寸是否满足游戏要求
+ * 3. 创建并初始化游戏实例
+ * 4. 运行游戏主循环
+ * 5. 清理资源并退出
  * 
+ * @param argc 参数个数
+ * @param argv 参数数组
  * @return int 退出码 - 0 表示成功，1 表示失败
  *****************************************************************************/
-int main(void) {
+int main(int argc, char** argv) {
+    // Parse command line options
+    options_t options;
+    options_init(&options);
+    if (!options_parse(&options, argc, argv)) {
+        options_print_usage(argv[0]);
+        return 1;
+    }
+
     // Check if terminal size is adequate before starting
     if (!is_terminal_size_valid()) {
         int width, height;
@@ -32,6 +43,7 @@ int main(void) {
         fprintf(stderr, "Failed to create game!\n");
         return 1;
     }
+    game->options = options;
 
     game_init(game);
     if (!game->running) {
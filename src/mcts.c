@@ -0,0 +1,796 @@
+#define _POSIX_C_SOURCE 200809L
+#include "mcts.h"
+#include "autopilot.h"
+#include "snake.h"
+#include "food.h"
+#include "grid.h"
+#include "zobrist.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MCTS_CACHE_LINE 64
+#define MCTS_OPPOSITE(dir) ((dir) ^ 1)
+#define MCTS_RING_MASK (MCTS_MAX_CELLS - 1)
+
+// Outcome of one snapshot move
+#define MCTS_MOVED  0
+#define MCTS_ATE    1
+#define MCTS_DIED   2
+
+// Per-thread search state, aligned so two workers never share a line
+struct mcts_worker {
+    int id;
+    pthread_t thread;
+    uint64_t generation;    // Last search this worker ran
+    mcts_t* mcts;
+    rng_t rng;              // Expansion, rollout and food randomness
+    mcts_node_t* nodes;     // Tree, node 0 is the root
+    int node_count;
+    int node_capacity;
+    mcts_state_t state;     // Clone of the root for the current iteration
+    long table_probes;
+    long table_hits;
+} __attribute__((aligned(MCTS_CACHE_LINE)));
+
+static void mcts_reset(game_t* game);
+static void mcts_steer(game_t* game);
+static void* mcts_worker_main(void* arg);
+
+// Static controller instance
+static controller_t mcts_controller = {
+    .name = "MCTS",
+    .reset = mcts_reset,
+    .steer = mcts_steer
+};
+
+static inline bool mcts_is_occupied(const mcts_state_t* state, int cell) {
+    return (state->occupied[cell >> 6] >> (cell & 63)) & 1;
+}
+
+static inline void mcts_occupy(mcts_state_t* state, int cell) {
+    state->occupied[cell >> 6] |= 1ULL << (cell & 63);
+}
+
+static inline void mcts_vacate(mcts_state_t* state, int cell) {
+    state->occupied[cell >> 6] &= ~(1ULL << (cell & 63));
+}
+
+static inline int mcts_tail_cell(const mcts_state_t* state) {
+    return state->body[(state->head - (state->length - 1)) & MCTS_RING_MASK];
+}
+
+/******************************************************************************
+ * @brief 计算实际使用的搜索线程数
+ * 
+ * @param threads 请求的线程数，0 表示每个在线 CPU 一个
+ * @return int 线程数，至少为 1
+ *****************************************************************************/
+int mcts_thread_count(int threads) {
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    return threads;
+}
+
+/******************************************************************************
+ * @brief 创建树搜索
+ * 
+ * 每个线程的节点池按每节拍迭代次数一次性分配（每次迭代最多扩展一个节点），
+ * 第 1 个以后的搜索线程也在这里创建并一直等待，之后的搜索不再分配内存，
+ * 也不再创建线程。线程创建失败时用已创建的线程搜索
+ * 
+ * @param width 棋盘宽度（含边框）
+ * @param height 棋盘高度（含边框）
+ * @param threads 搜索线程数
+ * @param rollouts 每个线程每节拍的迭代次数
+ * @param table_bits 置换表条目数的以 2 为底的对数，0 表示不使用置换表
+ * @return mcts_t* 树搜索指针，棋盘超过 MCTS_MAX_CELLS 或失败返回 NULL
+ *****************************************************************************/
+mcts_t* mcts_create(int width, int height, int threads, int rollouts, int table_bits) {
+    if (width < 3 || height < 3 || width * height > MCTS_MAX_CELLS ||
+        threads < 1 || rollouts < 1) {
+        return NULL;
+    }
+
+    mcts_t* mcts = calloc(1, sizeof(mcts_t));
+    if (!mcts) return NULL;
+
+    mcts->width = width;
+    mcts->height = height;
+    mcts->cell_count = width * height;
+    mcts->offsets[DIR_UP] = -width;
+    mcts->offsets[DIR_DOWN] = width;
+    mcts->offsets[DIR_LEFT] = -1;
+    mcts->offsets[DIR_RIGHT] = 1;
+    mcts->threads = threads;
+    mcts->rollouts = rollouts;
+    pthread_mutex_init(&mcts->lock, NULL);
+    pthread_cond_init(&mcts->wake, NULL);
+    pthread_cond_init(&mcts->done, NULL);
+    mcts->started = 1;
+
+    if (table_bits > 0) {
+        mcts->table = transposition_table_create(table_bits);
+        if (!mcts->table) {
+            free(mcts);
+            return NULL;
+        }
+    }
+
+    void* memory = NULL;
+    if (posix_memalign(&memory, MCTS_CACHE_LINE, sizeof(mcts_worker_t) * threads) != 0) {
+        transposition_table_destroy(mcts->table);
+        free(mcts);
+        return NULL;
+    }
+    mcts->workers = memory;
+    memset(mcts->workers, 0, sizeof(mcts_worker_t) * threads);
+
+    for (int i = 0; i < threads; i++) {
+        mcts_worker_t* worker = &mcts->workers[i];
+        worker->id = i;
+        worker->mcts = mcts;
+        worker->node_capacity = rollouts + 1;
+        worker->nodes = malloc(sizeof(mcts_node_t) * worker->node_capacity);
+        if (!worker->nodes) {
+            mcts_destroy(mcts);
+            return NULL;
+        }
+    }
+
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&mcts->workers[i].thread, NULL, mcts_worker_main,
+                           &mcts->workers[i]) != 0) {
+            break;
+        }
+        mcts->started++;
+    }
+
+    mcts_seed(mcts, 0);
+    return mcts;
+}
+
+/******************************************************************************
+ * @brief 销毁树搜索
+ * 
+ * 先让等待中的搜索线程退出并回收
+ * 
+ * @param mcts 树搜索指针
+ *****************************************************************************/
+void mcts_destroy(mcts_t* mcts) {
+    if (!mcts) return;
+
+    pthread_mutex_lock(&mcts->lock);
+    mcts->stopping = true;
+    pthread_cond_broadcast(&mcts->wake);
+    pthread_mutex_unlock(&mcts->lock);
+    for (int i = 1; i < mcts->started; i++) {
+        pthread_join(mcts->workers[i].thread, NULL);
+    }
+    pthread_mutex_destroy(&mcts->lock);
+    pthread_cond_destroy(&mcts->wake);
+    pthread_cond_destroy(&mcts->done);
+
+    for (int i = 0; i < mcts->threads; i++) {
+        free(mcts->workers[i].nodes);
+    }
+    free(mcts->workers);
+    transposition_table_destroy(mcts->table);
+    free(mcts);
+}
+
+/******************************************************************************
+ * @brief 为各线程设置随机种子
+ * 
+ * 每个线程的随机序列只取决于 seed 和线程序号
+ * 
+ * @param mcts 树搜索指针
+ * @param seed 随机种子
+ *****************************************************************************/
+void mcts_seed(mcts_t* mcts, uint64_t seed) {
+    if (!mcts) return;
+
+    for (int i = 0; i < mcts->threads; i++) {
+        rng_seed(&mcts->workers[i].rng, rng_mix_seed(seed + (uint64_t)i));
+    }
+}
+
+/******************************************************************************
+ * @brief 在快照中随机生成食物
+ * 
+ * 先随机抽样几次，棋盘很满时再从随机位置开始顺序查找空格
+ * 
+ * @param mcts 树搜索指针
+ * @param state 快照指针
+ *****************************************************************************/
+static void mcts_spawn_food(const mcts_t* mcts, mcts_state_t* state) {
+    if (state->food >= 0) {
+        state->hash ^= mcts->food_keys[state->food];
+    }
+    state->food = -1;
+    if (state->free_count <= 0) return;
+
+    int food = -1;
+    for (int attempt = 0; attempt < 8 && food < 0; attempt++) {
+        int cell = (int)rng_bounded(&state->rng, (uint32_t)mcts->cell_count);
+        if (!mcts_is_occupied(state, cell)) {
+            food = cell;
+        }
+    }
+
+    int start = (int)rng_bounded(&state->rng, (uint32_t)mcts->cell_count);
+    for (int i = 0; i < mcts->cell_count && food < 0; i++) {
+        int cell = start + i;
+        if (cell >= mcts->cell_count) cell -= mcts->cell_count;
+        if (!mcts_is_occupied(state, cell)) {
+            food = cell;
+        }
+    }
+
+    if (food >= 0) {
+        state->food = food;
+        state->hash ^= mcts->food_keys[food];
+    }
+}
+
+/******************************************************************************
+ * @brief 快照走一步
+ * 
+ * 与 game_tick 的规则一致：先移除蛇尾（生长时除外），再检查新蛇头，
+ * 吃到食物后下一步生长并重新生成食物。哈希值随每个变化增量更新
+ * 
+ * @param mcts 树搜索指针
+ * @param state 快照指针
+ * @param dir 移动方向（不能是反方向）
+ * @return int MCTS_MOVED、MCTS_ATE 或 MCTS_DIED
+ *****************************************************************************/
+static int mcts_state_step(const mcts_t* mcts, mcts_state_t* state, int dir) {
+    int head = state->body[state->head];
+    int next = head + mcts->offsets[dir];
+    state->hash ^= mcts->direction_keys[state->direction] ^ mcts->direction_keys[dir];
+    state->direction = (uint8_t)dir;
+
+    // A snake covering the whole board has nowhere left to grow
+    if (!state->grow || state->free_count == 0) {
+        int tail = mcts_tail_cell(state);
+        mcts_vacate(state, tail);
+        state->hash ^= mcts->body_keys[tail];
+        state->length--;
+        state->free_count++;
+    }
+    if (state->grow) {
+        state->hash ^= mcts->grow_key;
+        state->grow = 0;
+    }
+
+    if (mcts_is_occupied(state, next)) {
+        return MCTS_DIED;
+    }
+
+    mcts_occupy(state, next);
+    state->head = (state->head + 1) & MCTS_RING_MASK;
+    state->body[state->head] = (uint16_t)next;
+    state->length++;
+    state->free_count--;
+    state->hash ^= mcts->head_keys[head] ^ mcts->head_keys[next] ^ mcts->body_keys[next];
+
+    if (next == state->food) {
+        state->grow = 1;
+        state->hash ^= mcts->grow_key;
+        mcts_spawn_food(mcts, state);
+        return MCTS_ATE;
+    }
+    return MCTS_MOVED;
+}
+
+/******************************************************************************
+ * @brief 按棋盘在屏幕上的位置生成每个格子的 Zobrist 键
+ * 
+ * 与 zobrist.h 的键相同，快照的哈希值因此与游戏局面的哈希值一致。
+ * 只在棋盘位置变化时重新生成
+ * 
+ * @param mcts 树搜索指针
+ * @param grid 网格实例指针
+ *****************************************************************************/
+static void mcts_prepare_keys(mcts_t* mcts, grid_t* grid) {
+    if (mcts->keys_ready && mcts->key_offset_x == grid->offset_x &&
+        mcts->key_offset_y == grid->offset_y) {
+        return;
+    }
+
+    for (int cell = 0; cell < mcts->cell_count; cell++) {
+        int x = grid->offset_x + cell % mcts->width;
+        int y = grid->offset_y + cell / mcts->width;
+        mcts->body_keys[cell] = zobrist_key(ZOBRIST_BODY, x, y);
+        mcts->head_keys[cell] = zobrist_key(ZOBRIST_HEAD, x, y);
+        mcts->food_keys[cell] = zobrist_key(ZOBRIST_FOOD, x, y);
+    }
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        mcts->direction_keys[d] = zobrist_key(ZOBRIST_DIRECTION, d, 0);
+    }
+    mcts->grow_key = zobrist_key(ZOBRIST_GROW, 0, 0);
+
+    mcts->key_offset_x = grid->offset_x;
+    mcts->key_offset_y = grid->offset_y;
+    mcts->keys_ready = true;
+}
+
+/******************************************************************************
+ * @brief 从当前游戏生成根快照
+ * 
+ * 哈希值直接取游戏增量维护的局面哈希
+ * 
+ * @param mcts 树搜索指针
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void mcts_snapshot(mcts_t* mcts, game_t* game) {
+    mcts_state_t* root = &mcts->root;
+    snake_t* snake = game->snake;
+    grid_t* grid = game->grid;
+
+    mcts_prepare_keys(mcts, grid);
+
+    memset(root->occupied, 0, sizeof(root->occupied));
+    for (int x = 0; x < mcts->width; x++) {
+        mcts_occupy(root, x);
+        mcts_occupy(root, (mcts->height - 1) * mcts->width + x);
+    }
+    for (int y = 1; y < mcts->height - 1; y++) {
+        mcts_occupy(root, y * mcts->width);
+        mcts_occupy(root, y * mcts->width + mcts->width - 1);
+    }
+
+    // Tail first, so the head ends up in the last slot
+    root->length = snake->length;
+    root->head = snake->length - 1;
+    for (int i = 0; i < snake->length; i++) {
+        int cell = grid_cell_index(grid, snake_get_segment(snake, i));
+        root->body[root->head - i] = (uint16_t)cell;
+        mcts_occupy(root, cell);
+    }
+
+    root->food = -1;
+    if (game->food && game->food->active) {
+        root->food = grid_cell_index(grid, game->food->position);
+    }
+    root->free_count = grid_free_count(grid);
+    root->direction = (uint8_t)snake->direction;
+    root->grow = snake->should_grow;
+    root->hash = zobrist_game_hash(game);
+}
+
+/******************************************************************************
+ * @brief 找出不会立即撞上的方向
+ * 
+ * 即将离开的蛇尾算作空格
+ * 
+ * @param mcts 树搜索指针
+ * @param state 快照指针
+ * @param moves 输出方向
+ * @return int 方向个数（0 到 3）
+ *****************************************************************************/
+static int mcts_safe_moves(const mcts_t* mcts, const mcts_state_t* state, int moves[3]) {
+    int head = state->body[state->head];
+    int tail = state->grow ? -1 : mcts_tail_cell(state);
+    int back = MCTS_OPPOSITE(state->direction);
+    int count = 0;
+
+    for (int dir = DIR_UP; dir <= DIR_RIGHT; dir++) {
+        int next = head + mcts->offsets[dir];
+        if (dir != back && (!mcts_is_occupied(state, next) || next == tail)) {
+            moves[count++] = dir;
+        }
+    }
+
+    return count;
+}
+
+/******************************************************************************
+ * @brief 随机走子直到死亡或达到深度上限
+ * 
+ * 只在不会立即撞上的方向中选择，大多数时候优先选择靠近食物的方向，
+ * 其余时候完全随机
+ * 
+ * @param worker 工作线程指针
+ * @param discount 第一步奖励的权重
+ * @return float 折扣后的奖励之和
+ *****************************************************************************/
+static float mcts_rollout(mcts_worker_t* worker, float discount) {
+    const mcts_t* mcts = worker->mcts;
+    mcts_state_t* state = &worker->state;
+    float total = 0.0f;
+
+    for (int depth = 0; depth < MCTS_ROLLOUT_DEPTH; depth++) {
+        int candidates[3];
+        int count = mcts_safe_moves(mcts, state, candidates);
+        if (count == 0) {
+            return total + discount * MCTS_REWARD_DEATH;
+        }
+
+        // Moves that bring the head closer to the food
+        int greedy[3];
+        int greedy_count = 0;
+        if (state->food >= 0) {
+            int head = state->body[state->head];
+            int dx = state->food % mcts->width - head % mcts->width;
+            int dy = state->food / mcts->width - head / mcts->width;
+            for (int i = 0; i < count; i++) {
+                int dir = candidates[i];
+                if ((dir == DIR_UP && dy < 0) || (dir == DIR_DOWN && dy > 0) ||
+                    (dir == DIR_LEFT && dx < 0) || (dir == DIR_RIGHT && dx > 0)) {
+                    greedy[greedy_count++] = dir;
+                }
+            }
+        }
+
+        int dir;
+        if (greedy_count > 0 && rng_bounded(&worker->rng, 100) < MCTS_ROLLOUT_GREEDY) {
+            dir = greedy[greedy_count == 1 ? 0 : rng_bounded(&worker->rng, (uint32_t)greedy_count)];
+        } else {
+            dir = candidates[count == 1 ? 0 : rng_bounded(&worker->rng, (uint32_t)count)];
+        }
+        int outcome = mcts_state_step(mcts, state, dir);
+        if (outcome == MCTS_DIED) {
+            return total + discount * MCTS_REWARD_DEATH;
+        }
+        if (outcome == MCTS_ATE) {
+            total += discount * MCTS_REWARD_FOOD;
+        }
+        discount *= MCTS_DISCOUNT;
+    }
+
+    return total;
+}
+
+/******************************************************************************
+ * @brief 用置换表估计叶子局面的价值
+ * 
+ * 表中已有足够多次走子的局面直接取平均回报，否则走子一次并把结果
+ * 累加到表中
+ * 
+ * @param worker 工作线程指针
+ * @return float 叶子局面的回报（未乘以到达叶子的折扣）
+ *****************************************************************************/
+static float mcts_evaluate_leaf(mcts_worker_t* worker) {
+    transposition_table_t* table = worker->mcts->table;
+    uint64_t hash = worker->state.hash;
+    uint32_t visits;
+    float sum;
+
+    worker->table_probes++;
+    if (transposition_table_probe(table, hash, &visits, &sum) && visits >= MCTS_TT_MIN_VISITS) {
+        worker->table_hits++;
+        return sum / visits;
+    }
+
+    float value = mcts_rollout(worker, 1.0f);
+    transposition_table_add(table, hash, value);
+    return value;
+}
+
+/******************************************************************************
+ * @brief 按 UCB1 选择已展开的子节点
+ * 
+ * @param worker 工作线程指针
+ * @param node 父节点
+ * @param moves 可选的方向
+ * @param count 方向个数
+ * @return int 方向，没有已展开的子节点返回 -1
+ *****************************************************************************/
+static int mcts_select(mcts_worker_t* worker, const mcts_node_t* node,
+                       const int* moves, int count) {
+    float log_visits = logf((float)node->visits);
+    float best_score = -INFINITY;
+    int best = -1;
+
+    for (int i = 0; i < count; i++) {
+        int dir = moves[i];
+        int child_index = node->children[dir];
+        if (child_index < 0) continue;
+
+        const mcts_node_t* child = &worker->nodes[child_index];
+        float score = child->value / child->visits +
+                      MCTS_EXPLORATION * sqrtf(log_visits / child->visits);
+        if (score > best_score) {
+            best_score = score;
+            best = dir;
+        }
+    }
+
+    return best;
+}
+
+/******************************************************************************
+ * @brief 执行一次迭代：选择、扩展、随机走子、回传
+ * 
+ * 根快照用一次 memcpy 复制，再沿树中的走法重放
+ * 
+ * @param worker 工作线程指针
+ *****************************************************************************/
+static void mcts_iterate(mcts_worker_t* worker) {
+    const mcts_t* mcts = worker->mcts;
+    mcts_state_t* state = &worker->state;
+
+    memcpy(state, &mcts->root, sizeof(mcts_state_t));
+    rng_seed(&state->rng, rng_next(&worker->rng));
+
+    int path[MCTS_MAX_TREE_DEPTH + 1];
+    int depth = 0;
+    int node_index = 0;
+    path[depth++] = node_index;
+
+    float total = 0.0f;
+    float discount = 1.0f;
+    bool dead = false;
+
+    while (depth <= MCTS_MAX_TREE_DEPTH) {
+        mcts_node_t* node = &worker->nodes[node_index];
+
+        // Moves into a wall or the body are never worth a node
+        int moves[3];
+        int count = mcts_safe_moves(mcts, state, moves);
+        if (count == 0) {
+            total += discount * MCTS_REWARD_DEATH;
+            dead = true;
+            break;
+        }
+
+        // Expand a random untried move if there is room left in the pool
+        int untried = 0;
+        int dir = -1;
+        for (int i = 0; i < count; i++) {
+            if (node->children[moves[i]] < 0 &&
+                rng_bounded(&worker->rng, (uint32_t)++untried) == 0) {
+                dir = moves[i];
+            }
+        }
+
+        bool expanded = false;
+        if (dir >= 0 && worker->node_count < worker->node_capacity) {
+            int child_index = worker->node_count++;
+            mcts_node_t* child = &worker->nodes[child_index];
+            memset(child->children, -1, sizeof(child->children));
+            child->visits = 0;
+            child->value = 0.0f;
+            node->children[dir] = child_index;
+            expanded = true;
+        } else {
+            dir = mcts_select(worker, node, moves, count);
+            if (dir < 0) break;
+        }
+
+        node_index = node->children[dir];
+        path[depth++] = node_index;
+
+        int outcome = mcts_state_step(mcts, state, dir);
+        if (outcome == MCTS_DIED) {
+            total += discount * MCTS_REWARD_DEATH;
+            dead = true;
+            break;
+        }
+        if (outcome == MCTS_ATE) {
+            total += discount * MCTS_REWARD_FOOD;
+        }
+        discount *= MCTS_DISCOUNT;
+
+        if (expanded) break;
+    }
+
+    if (!dead) {
+        total += mcts->table ? discount * mcts_evaluate_leaf(worker)
+                             : mcts_rollout(worker, discount);
+    }
+
+    for (int i = 0; i < depth; i++) {
+        mcts_node_t* node = &worker->nodes[path[i]];
+        node->visits++;
+        node->value += total;
+    }
+}
+
+/******************************************************************************
+ * @brief 一个线程的一次搜索：从空树开始执行固定次数的迭代
+ * 
+ * @param worker 工作线程指针
+ *****************************************************************************/
+static void mcts_worker_search(mcts_worker_t* worker) {
+    mcts_node_t* root = &worker->nodes[0];
+    memset(root->children, -1, sizeof(root->children));
+    root->visits = 0;
+    root->value = 0.0f;
+    worker->node_count = 1;
+
+    for (int i = 0; i < worker->mcts->rollouts; i++) {
+        mcts_iterate(worker);
+    }
+}
+
+/******************************************************************************
+ * @brief 搜索线程主函数：等待每次搜索请求，搜索完成后通知调用线程
+ * 
+ * 根快照在请求之前写好，互斥锁保证线程看到的是完整的快照
+ * 
+ * @param arg 工作线程指针
+ * @return void* 始终返回 NULL
+ *****************************************************************************/
+static void* mcts_worker_main(void* arg) {
+    mcts_worker_t* worker = arg;
+    mcts_t* mcts = worker->mcts;
+
+    pthread_mutex_lock(&mcts->lock);
+    for (;;) {
+        while (worker->generation == mcts->generation && !mcts->stopping) {
+            pthread_cond_wait(&mcts->wake, &mcts->lock);
+        }
+        if (mcts->stopping) break;
+        worker->generation = mcts->generation;
+        pthread_mutex_unlock(&mcts->lock);
+
+        mcts_worker_search(worker);
+
+        pthread_mutex_lock(&mcts->lock);
+        if (--mcts->pending == 0) {
+            pthread_cond_signal(&mcts->done);
+        }
+    }
+    pthread_mutex_unlock(&mcts->lock);
+    return NULL;
+}
+
+/******************************************************************************
+ * @brief 搜索下一步的方向
+ * 
+ * 唤醒常驻的搜索线程，第 0 个线程在调用线程上运行，
+ * 全部结束后汇总各棵树根节点的访问次数，选择访问最多的方向
+ * 
+ * @param mcts 树搜索指针（必须与棋盘尺寸一致）
+ * @param game 游戏实例指针
+ * @param dir 输出方向
+ * @return bool 找到方向返回 true
+ *****************************************************************************/
+bool mcts_choose_direction(mcts_t* mcts, game_t* game, direction_t* dir) {
+    if (!mcts || !game || !game->snake || !game->grid || !dir) return false;
+    if (game->grid->width != mcts->width || game->grid->height != mcts->height) return false;
+
+    int64_t start = time_now_ns();
+    mcts_snapshot(mcts, game);
+
+    int started = mcts->started;
+    if (started > 1) {
+        pthread_mutex_lock(&mcts->lock);
+        mcts->generation++;
+        mcts->pending = started - 1;
+        pthread_cond_broadcast(&mcts->wake);
+        pthread_mutex_unlock(&mcts->lock);
+    }
+
+    mcts_worker_search(&mcts->workers[0]);
+
+    if (started > 1) {
+        pthread_mutex_lock(&mcts->lock);
+        while (mcts->pending > 0) {
+            pthread_cond_wait(&mcts->done, &mcts->lock);
+        }
+        pthread_mutex_unlock(&mcts->lock);
+    }
+
+    uint32_t visits[4] = {0, 0, 0, 0};
+    float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < started; i++) {
+        mcts_worker_t* worker = &mcts->workers[i];
+        mcts->table_probes += worker->table_probes;
+        mcts->table_hits += worker->table_hits;
+        worker->table_probes = 0;
+        worker->table_hits = 0;
+
+        const mcts_node_t* root = &worker->nodes[0];
+        for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+            if (root->children[d] >= 0) {
+                visits[d] += worker->nodes[root->children[d]].visits;
+                values[d] += worker->nodes[root->children[d]].value;
+            }
+        }
+    }
+    mcts->total_rollouts += (long)mcts->rollouts * started;
+    mcts->search_ns += time_now_ns() - start;
+
+    // Most visited move, ties broken by the better mean return
+    int best = -1;
+    for (int d = DIR_UP; d <= DIR_RIGHT; d++) {
+        if (visits[d] == 0) continue;
+        if (best < 0 || visits[d] > visits[best] ||
+            (visits[d] == visits[best] && values[d] / visits[d] > values[best] / visits[best])) {
+            best = d;
+        }
+    }
+    if (best < 0) return false;
+
+    *dir = (direction_t)best;
+    return true;
+}
+
+/******************************************************************************
+ * @brief 新一局开始时准备树搜索
+ * 
+ * 棋盘尺寸或搜索设置变化时重新创建，并用本局种子重置线程的随机序列、
+ * 清空置换表，使同一种子的对局结果可以复现（多线程共享置换表时除外）
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void mcts_reset(game_t* game) {
+    if (!game || !game->grid) return;
+
+    // Ticks the search cannot decide go to the autopilot
+    get_autopilot_controller()->reset(game);
+
+    int threads = mcts_thread_count(game->options.mcts_threads);
+    int rollouts = game->options.mcts_rollouts > 0 ? game->options.mcts_rollouts
+                                                   : MCTS_DEFAULT_ROLLOUTS;
+    int table_bits = game->options.mcts_table_bits;
+    mcts_t* mcts = game->mcts;
+
+    if (!mcts || mcts->width != game->grid->width || mcts->height != game->grid->height ||
+        mcts->threads != threads || mcts->rollouts != rollouts ||
+        (mcts->table ? mcts->table->bits : 0) != table_bits) {
+        // Keep the throughput counters across boards
+        long total_rollouts = mcts ? mcts->total_rollouts : 0;
+        int64_t search_ns = mcts ? mcts->search_ns : 0;
+        long table_probes = mcts ? mcts->table_probes : 0;
+        long table_hits = mcts ? mcts->table_hits : 0;
+
+        mcts_destroy(mcts);
+        mcts = mcts_create(game->grid->width, game->grid->height, threads, rollouts, table_bits);
+        if (mcts) {
+            mcts->total_rollouts = total_rollouts;
+            mcts->search_ns = search_ns;
+            mcts->table_probes = table_probes;
+            mcts->table_hits = table_hits;
+        }
+        game->mcts = mcts;
+    }
+    // Remembered so steering does not retry on every tick
+    game->mcts_unavailable = !mcts;
+
+    // Every game starts from an empty table so seeded games repeat
+    mcts_seed(mcts, game->seed);
+    transposition_table_clear(mcts ? mcts->table : NULL);
+}
+
+/******************************************************************************
+ * @brief 树搜索控制器：每个节拍前选择方向
+ * 
+ * 超过 MCTS_MAX_CELLS 的棋盘交给自动驾驶：创建失败记录在游戏实例中，
+ * 直到下一局的 reset 才重试
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void mcts_steer(game_t* game) {
+    if (!game || !game->snake) return;
+
+    if (!game->mcts && !game->mcts_unavailable) {
+        mcts_reset(game);
+    }
+
+    direction_t dir;
+    if (mcts_choose_direction(game->mcts, game, &dir)) {
+        snake_clear_turns(game->snake);
+        snake_set_direction(game->snake, dir);
+        return;
+    }
+
+    controller_t* fallback = get_autopilot_controller();
+    fallback->steer(game);
+}
+
+/******************************************************************************
+ * @brief 获取树搜索控制器
+ * 
+ * @return controller_t* 控制器指针
+ *****************************************************************************/
+controller_t* get_mcts_controller(void) {
+    return &mcts_controller;
+}
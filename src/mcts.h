@@ -0,0 +1,115 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "game.h"
+#include "rng.h"
+#include "transposition.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest board (border included) a snapshot can hold, a power of two.
+// Bigger boards are steered by the autopilot instead.
+#define MCTS_MAX_CELLS          4096
+
+// Search settings
+#define MCTS_DEFAULT_ROLLOUTS   256     // Iterations per thread and tick
+#define MCTS_MAX_TREE_DEPTH     32      // Moves selected inside the tree
+#define MCTS_ROLLOUT_DEPTH      48      // Random moves played past the tree
+#define MCTS_ROLLOUT_GREEDY     75      // Percent of rollout moves made towards the food
+#define MCTS_EXPLORATION        0.7f    // UCB1 exploration constant
+#define MCTS_DISCOUNT           0.98f   // Weight of each later reward
+#define MCTS_REWARD_FOOD        1.0f
+#define MCTS_REWARD_DEATH      -4.0f
+#define MCTS_TT_MIN_VISITS      1       // Rollouts stored for a position before later visits reuse their mean
+
+// Flat game snapshot, cloned once per iteration with a single memcpy.
+// Cells use the occupancy grid's indices. Walls and body share one bit
+// set, so a move is fatal exactly when its target bit is still set after
+// the tail has moved.
+typedef struct {
+    uint64_t occupied[MCTS_MAX_CELLS / 64];
+    uint16_t body[MCTS_MAX_CELLS];  // Ring buffer of body cells, head at `head`
+    rng_t rng;                      // Food spawns inside the search
+    int32_t head;
+    int32_t length;
+    int32_t food;                   // Cell of the food, -1 when the board is full
+    int32_t free_count;             // Empty interior cells
+    uint64_t hash;                  // Zobrist hash, equal to zobrist_game_hash of the same position
+    uint8_t direction;
+    uint8_t grow;                   // Grow on the next move
+} mcts_state_t;
+
+// Search tree node. Nodes hold moves only: every iteration replays the
+// moves from a fresh clone of the root, so food spawns are sampled anew.
+typedef struct {
+    int32_t children[4];    // Child per direction_t, -1 when not expanded
+    uint32_t visits;
+    float value;            // Sum of the returns of iterations through here
+} mcts_node_t;
+
+typedef struct mcts_worker mcts_worker_t;
+
+// Root-parallel Monte Carlo tree search. Each thread grows its own tree
+// from the same root snapshot; the root visit counts are summed and the
+// most visited move is played. Trees never share memory, so threads need
+// no locks and the result only depends on the seeds, not on scheduling.
+//
+// The optional transposition table is the exception: all threads share it
+// and it lives for a whole game. It caches rollout returns by position, so
+// a leaf already rolled out MCTS_TT_MIN_VISITS times, by any thread or in
+// an earlier tick, takes the stored mean instead of a new rollout. With
+// more than one thread, results then depend on scheduling.
+struct mcts {
+    int width;              // Board width including border
+    int height;             // Board height including border
+    int cell_count;
+    int offsets[4];         // Cell index delta per direction_t
+    int threads;
+    int rollouts;           // Iterations per thread and tick
+
+    // Zobrist keys per cell for the screen position of the board
+    int key_offset_x;
+    int key_offset_y;
+    bool keys_ready;
+    uint64_t body_keys[MCTS_MAX_CELLS];
+    uint64_t head_keys[MCTS_MAX_CELLS];
+    uint64_t food_keys[MCTS_MAX_CELLS];
+    uint64_t direction_keys[4];
+    uint64_t grow_key;
+    transposition_table_t* table;   // Shared rollout returns, NULL when disabled
+
+    mcts_state_t root;
+    mcts_worker_t* workers;
+
+    // Threads 1.. persist from mcts_create to mcts_destroy. Each search
+    // bumps `generation` and wakes them; the last one to finish signals
+    // `done`. The calling thread runs worker 0 itself.
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    int started;            // Workers running, worker 0 included
+    int pending;            // Workers still searching the current tick
+    uint64_t generation;    // Searches requested so far
+    bool stopping;
+
+    long total_rollouts;    // Iterations run since creation, all threads
+    int64_t search_ns;      // Wall time spent searching
+    long table_probes;      // Leaves looked up in the table
+    long table_hits;        // Leaves that skipped their rollout
+};
+
+// Search management
+mcts_t* mcts_create(int width, int height, int threads, int rollouts, int table_bits);
+void mcts_destroy(mcts_t* mcts);
+void mcts_seed(mcts_t* mcts, uint64_t seed);
+int mcts_thread_count(int threads);
+
+// Decision
+bool mcts_choose_direction(mcts_t* mcts, game_t* game, direction_t* dir);
+
+// Controller steering the snake with the tree search
+controller_t* get_mcts_controller(void);
+
+#endif // MCTS_H
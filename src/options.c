@@ -0,0 +1,186 @@
+#include "options.h"
+#include "transposition.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * @brief 初始化命令行选项为默认值
+ * 
+ * @param options 选项结构体指针
+ *****************************************************************************/
+void options_init(options_t* options) {
+    if (!options) return;
+
+    options->loop_mode = LOOP_EVENT;
+    options->renderer = RENDERER_NCURSES;
+    options->max_fps = OPTIONS_DEFAULT_FPS;
+    options->has_seed = false;
+    options->seed = 0;
+    options->record_path = NULL;
+    options->replay_path = NULL;
+    options->replay_speed = 1.0;
+    options->bot = BOT_NONE;
+    options->mcts_threads = 0;
+    options->mcts_rollouts = 0;
+    options->mcts_table_bits = 0;
+    options->frame_stats_path = NULL;
+}
+
+/******************************************************************************
+ * @brief 解析命令行参数
+ * 
+ * 支持的选项：
+ * - --loop event|sleep  主循环模式（默认 event）
+ * - --renderer ncurses|ansi 终端后端（默认 ncurses）
+ * - --fps N             每秒最多渲染的帧数，0 表示不限制（默认 60）
+ * - --seed N            随机种子，用于复现游戏
+ * - --record FILE       将输入记录到回放日志
+ * - --replay FILE       回放日志中录制的游戏
+ * - --speed X           回放速度倍率（默认 1）
+ * - --autopilot         由自动驾驶控制蛇
+ * - --hamilton          沿哈密顿回路控制蛇
+ * - --mcts              由蒙特卡洛树搜索控制蛇
+ * - --mcts-threads N    树搜索线程数（默认每个 CPU 一个）
+ * - --mcts-rollouts N   树搜索每线程每节拍的迭代次数
+ * - --mcts-table BITS   树搜索置换表大小（2^BITS 个条目，默认不使用）
+ * - --greedy            按到食物的距离场贪心控制蛇
+ * - --frame-stats FILE  退出时把帧耗时统计写入文件
+ * - -h, --help          显示帮助
+ * 
+ * @param options 选项结构体指针
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @return bool 解析成功返回 true，参数错误或请求帮助返回 false
+ *****************************************************************************/
+bool options_parse(options_t* options, int argc, char** argv) {
+    if (!options) return false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (strcmp(arg, "--loop") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "event") == 0) {
+                options->loop_mode = LOOP_EVENT;
+            } else if (strcmp(mode, "sleep") == 0) {
+                options->loop_mode = LOOP_SLEEP;
+            } else {
+                fprintf(stderr, "Unknown loop mode: %s\n", mode);
+                return false;
+            }
+        } else if (strcmp(arg, "--renderer") == 0 && i + 1 < argc) {
+            const char* renderer = argv[++i];
+            if (strcmp(renderer, "ncurses") == 0) {
+                options->renderer = RENDERER_NCURSES;
+            } else if (strcmp(renderer, "ansi") == 0) {
+                options->renderer = RENDERER_ANSI;
+            } else {
+                fprintf(stderr, "Unknown renderer: %s\n", renderer);
+                return false;
+            }
+        } else if (strcmp(arg, "--fps") == 0 && i + 1 < argc) {
+            options->max_fps = atoi(argv[++i]);
+            if (options->max_fps < 0) {
+                fprintf(stderr, "Invalid frame cap: %s\n", argv[i]);
+                return false;
+            }
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc) {
+            if (!options_parse_seed(argv[++i], &options->seed)) {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i]);
+                return false;
+            }
+            options->has_seed = true;
+        } else if (strcmp(arg, "--record") == 0 && i + 1 < argc) {
+            options->record_path = argv[++i];
+        } else if (strcmp(arg, "--replay") == 0 && i + 1 < argc) {
+            options->replay_path = argv[++i];
+        } else if (strcmp(arg, "--speed") == 0 && i + 1 < argc) {
+            options->replay_speed = strtod(argv[++i], NULL);
+            if (options->replay_speed <= 0.0) {
+                fprintf(stderr, "Invalid replay speed: %s\n", argv[i]);
+                return false;
+            }
+        } else if (strcmp(arg, "--autopilot") == 0) {
+            options->bot = BOT_AUTOPILOT;
+        } else if (strcmp(arg, "--hamilton") == 0) {
+            options->bot = BOT_HAMILTON;
+        } else if (strcmp(arg, "--mcts") == 0) {
+            options->bot = BOT_MCTS;
+        } else if (strcmp(arg, "--greedy") == 0) {
+            options->bot = BOT_GREEDY;
+        } else if (strcmp(arg, "--frame-stats") == 0 && i + 1 < argc) {
+            options->frame_stats_path = argv[++i];
+        } else if (strcmp(arg, "--mcts-threads") == 0 && i + 1 < argc) {
+            options->mcts_threads = atoi(argv[++i]);
+        } else if (strcmp(arg, "--mcts-rollouts") == 0 && i + 1 < argc) {
+            options->mcts_rollouts = atoi(argv[++i]);
+        } else if (strcmp(arg, "--mcts-table") == 0 && i + 1 < argc) {
+            options->mcts_table_bits = atoi(argv[++i]);
+            if (options->mcts_table_bits < 0 || options->mcts_table_bits > TRANSPOSITION_MAX_BITS) {
+                fprintf(stderr, "Invalid table size: %s\n", argv[i]);
+                return false;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * @brief 解析随机种子
+ * 
+ * 接受十进制、0x 开头的十六进制或 0 开头的八进制无符号整数，
+ * 整个字符串都必须是数字，超出 64 位或带负号时失败
+ * 
+ * @param text 参数文本
+ * @param seed 输出参数 - 种子
+ * @return bool 解析成功返回 true
+ *****************************************************************************/
+bool options_parse_seed(const char* text, uint64_t* seed) {
+    if (!text || !seed) return false;
+
+    const char* digits = text;
+    while (*digits == ' ' || *digits == '\t') digits++;
+    if (*digits == '\0' || *digits == '-' || *digits == '+') return false;
+
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(digits, &end, 0);
+    if (errno != 0 || *end != '\0') return false;
+
+    *seed = (uint64_t)value;
+    return true;
+}
+
+/******************************************************************************
+ * @brief 打印命令行用法
+ * 
+ * @param program 程序名
+ *****************************************************************************/
+void options_print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --loop event|sleep   Main loop mode (default: event)\n");
+    printf("  --renderer ncurses|ansi  Terminal backend (default: ncurses)\n");
+    printf("  --fps N              Render at most N frames per second, 0 for no cap (default: %d)\n",
+           OPTIONS_DEFAULT_FPS);
+    printf("  --seed N             Random seed for reproducible games\n");
+    printf("  --record FILE        Record an input log for replay\n");
+    printf("  --replay FILE        Play back a recorded input log\n");
+    printf("  --speed X            Replay speed multiplier (default: 1)\n");
+    printf("  --autopilot          Let the computer steer the snake\n");
+    printf("  --hamilton           Let the computer fill the board along a Hamiltonian cycle\n");
+    printf("  --mcts               Let a Monte Carlo tree search steer the snake\n");
+    printf("  --mcts-threads N     Tree search threads, 0 for one per CPU (default: 0)\n");
+    printf("  --mcts-rollouts N    Tree search iterations per thread and tick (default: 256)\n");
+    printf("  --mcts-table BITS    Share rollout results in a 2^BITS entry table, 0 for none (default: 0)\n");
+    printf("  --greedy             Let the computer take the shortest way to the food\n");
+    printf("  --frame-stats FILE   Write per-frame timings to FILE on exit (F toggles the overlay)\n");
+    printf("  -h, --help           Show this help\n");
+}
@@ -0,0 +1,54 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Main loop modes
+typedef enum {
+    LOOP_EVENT,     // Block in poll() on stdin and a tick timer
+    LOOP_SLEEP      // Poll getch() and sleep between frames
+} loop_mode_t;
+
+// Terminal backends
+typedef enum {
+    RENDERER_NCURSES,   // ncurses screen, see ui.c
+    RENDERER_ANSI       // Raw escape sequences, one write() per frame, see ansi.h
+} renderer_mode_t;
+
+// Computer players
+typedef enum {
+    BOT_NONE,       // Keyboard only
+    BOT_AUTOPILOT,  // Breadth-first path search, see autopilot.h
+    BOT_HAMILTON,   // Hamiltonian cycle with shortcuts, see hamilton.h
+    BOT_MCTS,       // Monte Carlo tree search, see mcts.h
+    BOT_GREEDY      // Nearest way to the food from a distance field, see greedy.h
+} bot_mode_t;
+
+// Command line options
+typedef struct {
+    loop_mode_t loop_mode;
+    renderer_mode_t renderer;
+    int max_fps;            // Render at most this many frames per second, 0 for no cap
+    bool has_seed;          // Seed the first game with `seed`
+    uint64_t seed;
+    const char* record_path;    // Record an input log to this file
+    const char* replay_path;    // Play back an input log from this file
+    double replay_speed;        // Playback speed multiplier
+    bot_mode_t bot;             // Computer player steering the snake
+    int mcts_threads;           // Tree search threads, 0 for one per online CPU
+    int mcts_rollouts;          // Tree search iterations per thread and tick, 0 for default
+    int mcts_table_bits;        // Log2 of the tree search transposition table size, 0 for none
+    const char* frame_stats_path;   // Write frame timings to this file on exit
+} options_t;
+
+// Default frame cap, above the fastest level's tick rate
+#define OPTIONS_DEFAULT_FPS 60
+
+// Option parsing
+void options_init(options_t* options);
+bool options_parse(options_t* options, int argc, char** argv);
+bool options_parse_seed(const char* text, uint64_t* seed);
+void options_print_usage(const char* program);
+
+#endif // OPTIONS_H
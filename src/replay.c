@@ -0,0 +1,351 @@
+#include "replay.h"
+#include "snake.h"
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * @brief 写入一个无符号 LEB128 变长整数
+ * 
+ * @param file 输出文件
+ * @param value 要写入的值
+ *****************************************************************************/
+static void replay_write_varint(FILE* file, uint64_t value) {
+    uint8_t buffer[10];
+    int length = 0;
+
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        buffer[length++] = byte | (value ? 0x80 : 0);
+    } while (value);
+
+    fwrite(buffer, 1, length, file);
+}
+
+/******************************************************************************
+ * @brief 以小端序写入整数
+ * 
+ * @param file 输出文件
+ * @param value 要写入的值
+ * @param bytes 字节数
+ *****************************************************************************/
+static void replay_write_le(FILE* file, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        fputc((int)((value >> (8 * i)) & 0xFF), file);
+    }
+}
+
+/******************************************************************************
+ * @brief 创建回放录制器
+ * 
+ * 打开日志文件并写入文件头
+ * 
+ * @param path 日志文件路径
+ * @return replay_recorder_t* 录制器指针，失败返回 NULL
+ *****************************************************************************/
+replay_recorder_t* replay_recorder_open(const char* path) {
+    if (!path) return NULL;
+
+    replay_recorder_t* recorder = malloc(sizeof(replay_recorder_t));
+    if (!recorder) return NULL;
+
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file) {
+        free(recorder);
+        return NULL;
+    }
+
+    recorder->game_open = false;
+    recorder->last_event_tick = 0;
+
+    fwrite(REPLAY_MAGIC, 1, 4, recorder->file);
+    fputc(REPLAY_VERSION, recorder->file);
+
+    return recorder;
+}
+
+/******************************************************************************
+ * @brief 关闭回放录制器
+ * 
+ * @param recorder 录制器指针
+ *****************************************************************************/
+void replay_recorder_close(replay_recorder_t* recorder) {
+    if (!recorder) return;
+
+    fclose(recorder->file);
+    free(recorder);
+}
+
+/******************************************************************************
+ * @brief 开始录制一局游戏
+ * 
+ * 写入本局的等级、棋盘尺寸和随机种子；上一局未结束时先记为放弃
+ * 
+ * @param recorder 录制器指针
+ * @param game 游戏实例指针（已设置好本局参数）
+ *****************************************************************************/
+void replay_recorder_begin_game(replay_recorder_t* recorder, game_t* game) {
+    if (!recorder || !game) return;
+
+    if (recorder->game_open) {
+        replay_recorder_end_game(recorder, game->tick_count, false);
+    }
+
+    fputc(REPLAY_GAME_TAG, recorder->file);
+    fputc(game->level, recorder->file);
+    replay_write_le(recorder->file, (uint64_t)game->board_width, 2);
+    replay_write_le(recorder->file, (uint64_t)game->board_height, 2);
+    replay_write_le(recorder->file, game->seed, 8);
+
+    recorder->game_open = true;
+    recorder->last_event_tick = 0;
+}
+
+/******************************************************************************
+ * @brief 记录一次转向
+ * 
+ * @param recorder 录制器指针
+ * @param tick 发生转向的节拍序号
+ * @param dir 该节拍蛇采用的方向
+ *****************************************************************************/
+void replay_recorder_turn(replay_recorder_t* recorder, long tick, direction_t dir) {
+    if (!recorder || !recorder->game_open) return;
+
+    uint64_t delta = (uint64_t)(tick - recorder->last_event_tick);
+    replay_write_varint(recorder->file, (delta << 3) | (uint64_t)dir);
+    recorder->last_event_tick = tick;
+}
+
+/******************************************************************************
+ * @brief 结束录制当前这局游戏
+ * 
+ * @param recorder 录制器指针
+ * @param ticks 本局执行的节拍总数
+ * @param game_over true 表示蛇死亡结束，false 表示中途放弃
+ *****************************************************************************/
+void replay_recorder_end_game(replay_recorder_t* recorder, long ticks, bool game_over) {
+    if (!recorder || !recorder->game_open) return;
+
+    uint64_t delta = (uint64_t)(ticks - recorder->last_event_tick);
+    uint64_t code = game_over ? REPLAY_CODE_GAME_OVER : REPLAY_CODE_ABANDONED;
+    replay_write_varint(recorder->file, (delta << 3) | code);
+
+    recorder->game_open = false;
+}
+
+/******************************************************************************
+ * @brief 读取一个无符号 LEB128 变长整数
+ * 
+ * @param player 回放器指针
+ * @param value 输出值
+ * @return bool 成功返回 true，数据截断或过长返回 false
+ *****************************************************************************/
+static bool replay_read_varint(replay_player_t* player, uint64_t* value) {
+    uint64_t result = 0;
+
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (player->pos >= player->size) return false;
+
+        uint8_t byte = player->data[player->pos++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * @brief 以小端序读取整数
+ * 
+ * @param player 回放器指针
+ * @param bytes 字节数
+ * @param value 输出值
+ * @return bool 成功返回 true，数据截断返回 false
+ *****************************************************************************/
+static bool replay_read_le(replay_player_t* player, int bytes, uint64_t* value) {
+    if (player->pos + (size_t)bytes > player->size) return false;
+
+    uint64_t result = 0;
+    for (int i = 0; i < bytes; i++) {
+        result |= (uint64_t)player->data[player->pos++] << (8 * i);
+    }
+
+    *value = result;
+    return true;
+}
+
+/******************************************************************************
+ * @brief 解码下一个事件作为待处理事件
+ * 
+ * @param player 回放器指针
+ *****************************************************************************/
+static void replay_decode_event(replay_player_t* player) {
+    uint64_t value;
+
+    player->event_valid = replay_read_varint(player, &value);
+    if (!player->event_valid) return;
+
+    player->event_tick += (long)(value >> 3);
+    player->event_code = (int)(value & 7);
+}
+
+/******************************************************************************
+ * @brief 打开回放日志
+ * 
+ * 将整个日志读入内存并校验文件头
+ * 
+ * @param path 日志文件路径
+ * @return replay_player_t* 回放器指针，失败返回 NULL
+ *****************************************************************************/
+replay_player_t* replay_player_open(const char* path) {
+    if (!path) return NULL;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    replay_player_t* player = calloc(1, sizeof(replay_player_t));
+    if (!player) {
+        fclose(file);
+        return NULL;
+    }
+
+    // Read the whole log
+    size_t capacity = 4096;
+    player->data = malloc(capacity);
+    while (player->data) {
+        player->size += fread(player->data + player->size, 1,
+                              capacity - player->size, file);
+        if (player->size < capacity) break;
+
+        capacity *= 2;
+        uint8_t* data = realloc(player->data, capacity);
+        if (!data) {
+            free(player->data);
+            player->data = NULL;
+        } else {
+            player->data = data;
+        }
+    }
+    fclose(file);
+
+    if (!player->data || player->size < 5 ||
+        memcmp(player->data, REPLAY_MAGIC, 4) != 0 ||
+        player->data[4] != REPLAY_VERSION) {
+        replay_player_close(player);
+        return NULL;
+    }
+
+    player->pos = 5;
+    return player;
+}
+
+/******************************************************************************
+ * @brief 关闭回放器
+ * 
+ * @param player 回放器指针
+ *****************************************************************************/
+void replay_player_close(replay_player_t* player) {
+    if (!player) return;
+
+    free(player->data);
+    free(player);
+}
+
+/******************************************************************************
+ * @brief 开始回放下一局游戏
+ * 
+ * 读取本局参数，按录制时的棋盘尺寸、种子和等级重新开局
+ * 
+ * @param player 回放器指针
+ * @param game 游戏实例指针
+ * @return bool 成功返回 true，没有更多对局或数据损坏返回 false
+ *****************************************************************************/
+bool replay_player_begin_game(replay_player_t* player, game_t* game) {
+    if (!player || !game || player->pos >= player->size) return false;
+
+    uint64_t tag, level, width, height, seed;
+    if (!replay_read_le(player, 1, &tag) || tag != REPLAY_GAME_TAG ||
+        !replay_read_le(player, 1, &level) ||
+        !replay_read_le(player, 2, &width) ||
+        !replay_read_le(player, 2, &height) ||
+        !replay_read_le(player, 8, &seed)) {
+        return false;
+    }
+
+    game_set_board_size(game, (int)width, (int)height);
+    game_set_seed(game, seed);
+    game_change_level(game, (int)level);
+    if (!game->snake) return false;
+
+    player->game_open = true;
+    player->event_tick = 0;
+    replay_decode_event(player);
+    player->games++;
+
+    return true;
+}
+
+/******************************************************************************
+ * @brief 在执行下一个节拍前推进回放
+ * 
+ * 应用所有发生在该节拍的转向，并判断录制的对局是否在此结束
+ * 
+ * @param player 回放器指针
+ * @param game 游戏实例指针
+ * @return replay_status_t 回放状态
+ *****************************************************************************/
+replay_status_t replay_player_step(replay_player_t* player, game_t* game) {
+    if (!player || !game || !player->game_open) return REPLAY_END;
+
+    while (player->event_valid && player->event_code <= DIR_RIGHT &&
+           player->event_tick <= game->tick_count) {
+        game->snake->direction = (direction_t)player->event_code;
+        snake_clear_turns(game->snake);
+        replay_decode_event(player);
+    }
+
+    if (!player->event_valid) {
+        player->game_open = false;
+        return REPLAY_ERROR;
+    }
+
+    if (player->event_tick <= game->tick_count) {
+        return REPLAY_END;
+    }
+
+    return REPLAY_CONTINUE;
+}
+
+/******************************************************************************
+ * @brief 校验对局结束时的状态与录制一致
+ * 
+ * 蛇死亡或到达录制的结束事件时调用：两者必须在同一节拍、以同样方式结束，
+ * 否则计为一次不一致
+ * 
+ * @param player 回放器指针
+ * @param game 游戏实例指针
+ * @return bool 一致返回 true，否则返回 false
+ *****************************************************************************/
+bool replay_player_check_end(replay_player_t* player, game_t* game) {
+    if (!player || !game) return false;
+
+    bool died = game->next_state == STATE_GAME_OVER;
+    bool matched = player->event_valid &&
+                   player->event_tick == game->tick_count &&
+                   died == (player->event_code == REPLAY_CODE_GAME_OVER);
+
+    if (!matched) {
+        player->mismatches++;
+    }
+
+    // Skip any turns left over after an early death
+    while (player->event_valid && player->event_code <= DIR_RIGHT) {
+        replay_decode_event(player);
+    }
+
+    player->game_open = false;
+    return matched;
+}
@@ -0,0 +1,69 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game.h"
+#include "utils.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Replay log format (all integers little endian):
+//
+//   file header: "SNKR" magic, u8 version
+//   per game:    u8 'G', u8 level, u16 board width, u16 board height, u64 seed
+//                followed by events, each one unsigned LEB128 varint holding
+//                (ticks since previous event << 3) | code
+//
+// Codes 0-3 are the direction the snake took on that tick, REPLAY_CODE_GAME_OVER
+// and REPLAY_CODE_ABANDONED end the game after the given number of ticks.
+#define REPLAY_MAGIC            "SNKR"
+#define REPLAY_VERSION          1
+#define REPLAY_GAME_TAG         'G'
+#define REPLAY_CODE_GAME_OVER   4
+#define REPLAY_CODE_ABANDONED   5
+
+// Result of stepping a replay before a tick
+typedef enum {
+    REPLAY_CONTINUE,        // Run the next tick
+    REPLAY_END,             // The recorded game ends here
+    REPLAY_ERROR            // Log is truncated or corrupt
+} replay_status_t;
+
+// Replay recorder
+struct replay_recorder {
+    FILE* file;
+    bool game_open;
+    long last_event_tick;
+};
+
+// Replay player, reads the whole log into memory
+struct replay_player {
+    uint8_t* data;
+    size_t size;
+    size_t pos;
+
+    bool game_open;
+    long event_tick;        // Tick of the pending event
+    int event_code;         // Code of the pending event
+    bool event_valid;
+
+    // Verification counters
+    long games;
+    long mismatches;
+};
+
+// Recording
+replay_recorder_t* replay_recorder_open(const char* path);
+void replay_recorder_close(replay_recorder_t* recorder);
+void replay_recorder_begin_game(replay_recorder_t* recorder, game_t* game);
+void replay_recorder_turn(replay_recorder_t* recorder, long tick, direction_t dir);
+void replay_recorder_end_game(replay_recorder_t* recorder, long ticks, bool game_over);
+
+// Playback
+replay_player_t* replay_player_open(const char* path);
+void replay_player_close(replay_player_t* player);
+bool replay_player_begin_game(replay_player_t* player, game_t* game);
+replay_status_t replay_player_step(replay_player_t* player, game_t* game);
+bool replay_player_check_end(replay_player_t* player, game_t* game);
+
+#endif // REPLAY_H
@@ -0,0 +1,128 @@
+#define _POSIX_C_SOURCE 200809L
+#include "rng.h"
+#include <time.h>
+#include <unistd.h>
+
+/******************************************************************************
+ * @brief 循环左移
+ * 
+ * @param x 输入值
+ * @param k 移动位数
+ * @return uint64_t 结果
+ *****************************************************************************/
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/******************************************************************************
+ * @brief SplitMix64 混合函数
+ * 
+ * 将任意 64 位种子扩散为统计性质良好的值，用于初始化生成器状态
+ * 和派生下一局的种子
+ * 
+ * @param seed 输入种子
+ * @return uint64_t 混合后的值
+ *****************************************************************************/
+uint64_t rng_mix_seed(uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/******************************************************************************
+ * @brief 用种子初始化生成器
+ * 
+ * 同一种子总是产生相同的随机序列
+ * 
+ * @param rng 生成器指针
+ * @param seed 种子
+ *****************************************************************************/
+void rng_seed(rng_t* rng, uint64_t seed) {
+    if (!rng) return;
+
+    for (int i = 0; i < 4; i++) {
+        seed = rng_mix_seed(seed);
+        rng->state[i] = seed;
+    }
+}
+
+/******************************************************************************
+ * @brief 根据当前时间和进程号生成种子
+ * 
+ * 未指定种子时使用，同一时刻启动的多个进程也会得到不同种子
+ * 
+ * @return uint64_t 种子
+ *****************************************************************************/
+uint64_t rng_seed_from_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    uint64_t seed = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return rng_mix_seed(seed ^ ((uint64_t)getpid() << 32));
+}
+
+/******************************************************************************
+ * @brief 生成下一个 64 位随机数（xoshiro256**）
+ * 
+ * @param rng 生成器指针
+ * @return uint64_t 随机数
+ *****************************************************************************/
+uint64_t rng_next(rng_t* rng) {
+    uint64_t* s = rng->state;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+
+    return result;
+}
+
+/******************************************************************************
+ * @brief 生成 [0, range) 范围内无偏的随机数
+ * 
+ * Lemire 乘法取高位法：用 32x32 位乘法代替取模，只在极少数
+ * 会引入偏差的情况下重新抽取
+ * 
+ * @param rng 生成器指针
+ * @param range 范围上限（不含），为 0 时返回 0
+ * @return uint32_t 随机数
+ *****************************************************************************/
+uint32_t rng_bounded(rng_t* rng, uint32_t range) {
+    if (range == 0) return 0;
+
+    uint64_t m = (rng_next(rng) >> 32) * (uint64_t)range;
+    uint32_t low = (uint32_t)m;
+
+    if (low < range) {
+        uint32_t threshold = (uint32_t)(-range) % range;
+        while (low < threshold) {
+            m = (rng_next(rng) >> 32) * (uint64_t)range;
+            low = (uint32_t)m;
+        }
+    }
+
+    return (uint32_t)(m >> 32);
+}
+
+/******************************************************************************
+ * @brief 生成 [min, max] 范围内的随机整数（包含边界）
+ * 
+ * @param rng 生成器指针
+ * @param min 最小值
+ * @param max 最大值
+ * @return int 随机数
+ *****************************************************************************/
+int rng_range(rng_t* rng, int min, int max) {
+    if (min > max) {
+        int temp = min;
+        min = max;
+        max = temp;
+    }
+    return min + (int)rng_bounded(rng, (uint32_t)(max - min) + 1);
+}
@@ -0,0 +1,22 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// xoshiro256** pseudo-random generator. Each game owns one, so games are
+// reproducible from their seed and never contend on shared libc state.
+typedef struct {
+    uint64_t state[4];
+} rng_t;
+
+// Seeding
+void rng_seed(rng_t* rng, uint64_t seed);
+uint64_t rng_seed_from_clock(void);
+uint64_t rng_mix_seed(uint64_t seed);
+
+// Number generation
+uint64_t rng_next(rng_t* rng);
+uint32_t rng_bounded(rng_t* rng, uint32_t range);
+int rng_range(rng_t* rng, int min, int max);
+
+#endif // RNG_H
@@ -0,0 +1,105 @@
+#include "scheduler.h"
+#include <stddef.h>
+
+/******************************************************************************
+ * @brief 初始化节拍调度器
+ * 
+ * @param scheduler 调度器指针
+ * @param max_catchup 每次推进最多补执行的节拍数
+ *****************************************************************************/
+void scheduler_init(scheduler_t* scheduler, int max_catchup) {
+    if (!scheduler) return;
+
+    scheduler->tick_ns = 0;
+    scheduler->last_time_ns = 0;
+    scheduler->accumulator_ns = 0;
+    scheduler->max_catchup = max_catchup > 0 ? max_catchup : 1;
+    scheduler->running = false;
+    scheduler->last_slip_ns = 0;
+    scheduler->max_slip_ns = 0;
+    scheduler->total_ticks = 0;
+    scheduler->dropped_ticks = 0;
+}
+
+/******************************************************************************
+ * @brief 以指定节拍间隔启动调度器
+ * 
+ * 从 now_ns 开始计时，第一个节拍在 now_ns + tick_ms 到期。
+ * 进入游戏或取消暂停时调用，避免把暂停时间当作欠下的节拍补执行
+ * 
+ * @param scheduler 调度器指针
+ * @param tick_ms 节拍间隔（毫秒）
+ * @param now_ns 当前单调时钟时间（纳秒）
+ *****************************************************************************/
+void scheduler_start(scheduler_t* scheduler, int tick_ms, int64_t now_ns) {
+    if (!scheduler) return;
+
+    scheduler->tick_ns = (int64_t)(tick_ms > 0 ? tick_ms : 1) * 1000000LL;
+    scheduler->last_time_ns = now_ns;
+    scheduler->accumulator_ns = 0;
+    scheduler->running = true;
+}
+
+/******************************************************************************
+ * @brief 停止调度器（暂停、离开游戏界面时调用）
+ * 
+ * @param scheduler 调度器指针
+ *****************************************************************************/
+void scheduler_stop(scheduler_t* scheduler) {
+    if (!scheduler) return;
+    scheduler->running = false;
+}
+
+/******************************************************************************
+ * @brief 推进调度器并返回本帧应执行的节拍数
+ * 
+ * 将距上次调用经过的时间累加到累加器，按整节拍消耗。
+ * 每帧最多返回 max_catchup 个节拍；超出预算的欠账直接丢弃，
+ * 防止机器过载时陷入越追越慢的死循环。同时记录每个节拍相对
+ * 其截止时间的延迟
+ * 
+ * @param scheduler 调度器指针
+ * @param now_ns 当前单调时钟时间（纳秒）
+ * @return int 本帧应执行的节拍数
+ *****************************************************************************/
+int scheduler_advance(scheduler_t* scheduler, int64_t now_ns) {
+    if (!scheduler || !scheduler->running) return 0;
+
+    scheduler->accumulator_ns += now_ns - scheduler->last_time_ns;
+    scheduler->last_time_ns = now_ns;
+
+    int ticks = 0;
+    while (scheduler->accumulator_ns >= scheduler->tick_ns &&
+           ticks < scheduler->max_catchup) {
+        // The tick was due accumulator - tick_ns nanoseconds ago
+        int64_t slip = scheduler->accumulator_ns - scheduler->tick_ns;
+        scheduler->last_slip_ns = slip;
+        if (slip > scheduler->max_slip_ns) {
+            scheduler->max_slip_ns = slip;
+        }
+
+        scheduler->accumulator_ns -= scheduler->tick_ns;
+        ticks++;
+    }
+
+    // Drop whatever the catch-up budget could not cover
+    if (scheduler->accumulator_ns >= scheduler->tick_ns) {
+        scheduler->dropped_ticks += scheduler->accumulator_ns / scheduler->tick_ns;
+        scheduler->accumulator_ns %= scheduler->tick_ns;
+    }
+
+    scheduler->total_ticks += ticks;
+    return ticks;
+}
+
+/******************************************************************************
+ * @brief 获取下一个节拍的截止时间
+ * 
+ * @param scheduler 调度器指针
+ * @return int64_t 截止时间（纳秒，CLOCK_MONOTONIC），调度器未运行返回 -1
+ *****************************************************************************/
+int64_t scheduler_next_deadline(const scheduler_t* scheduler) {
+    if (!scheduler || !scheduler->running) return -1;
+
+    return scheduler->last_time_ns + scheduler->tick_ns - scheduler->accumulator_ns;
+}
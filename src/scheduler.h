@@ -0,0 +1,36 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Maximum simulation ticks run in one frame when catching up
+#define SCHEDULER_MAX_CATCHUP 5
+
+// Fixed-timestep tick scheduler driven by the monotonic clock.
+// Elapsed time is accumulated and consumed in whole ticks, so ticks land
+// on multiples of tick_ns regardless of how long rendering and input take.
+typedef struct {
+    int64_t tick_ns;        // Simulation tick length
+    int64_t last_time_ns;   // Time of the previous scheduler_advance call
+    int64_t accumulator_ns; // Elapsed time not yet consumed by ticks
+    int max_catchup;        // Tick budget per advance call
+    bool running;
+
+    // Deadline statistics
+    int64_t last_slip_ns;   // How late the most recent tick ran
+    int64_t max_slip_ns;    // Worst slip since the scheduler started
+    int64_t total_ticks;
+    int64_t dropped_ticks;  // Ticks skipped because the catch-up budget ran out
+} scheduler_t;
+
+// Scheduler lifecycle
+void scheduler_init(scheduler_t* scheduler, int max_catchup);
+void scheduler_start(scheduler_t* scheduler, int tick_ms, int64_t now_ns);
+void scheduler_stop(scheduler_t* scheduler);
+
+// Tick scheduling
+int scheduler_advance(scheduler_t* scheduler, int64_t now_ns);
+int64_t scheduler_next_deadline(const scheduler_t* scheduler);
+
+#endif // SCHEDULER_H
@@ -1,21 +1,69 @@
+#define _POSIX_C_SOURCE 200809L
 #include "score.h"
 #include "utils.h"
 #include "food.h"
+#include "leaderboard.h"
+#include "snake.h"
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Finished games waiting for the leaderboard; when it is full the game
+// thread submits the next one itself
+#define SCORE_QUEUE_SIZE    8
+
+// Background writer of the high score file and the leaderboard. The game
+// thread only stores what to save and signals; the writer does all file
+// I/O. Only one high score save waits at a time: a newer one replaces it
+// if the score is higher.
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    bool started;
+    bool stopping;
+    bool pending;           // pending_score is waiting to be written
+    int pending_score;
+    leaderboard_record_t queue[SCORE_QUEUE_SIZE];   // Ring of games to submit
+    int queue_head;
+    int queue_count;
+} score_writer = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER
+};
+
+// Best score known to this process: loaded once by score_init, raised by
+// every save, so checks never touch the disk
+static int cached_high_score;
+static bool cached_high_score_loaded;
+
+// Shared leaderboard file, opened by the writer thread so startup never
+// waits for its lock. NULL until then or if unusable; other threads read
+// it with __atomic_load_n.
+static leaderboard_t* leaderboard;
 
 /******************************************************************************
  * @brief 初始化分数系统
  * 
- * 重置当前分数为 0，从文件加载历史最高分
+ * 重置当前分数为 0，从文件加载一次历史最高分并缓存，
+ * 启动后台写入线程。排行榜文件由写入线程打开，打开之前视为不可用
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
 void score_init(game_t* game) {
     if (!game) return;
 
+    if (!cached_high_score_loaded) {
+        cached_high_score = score_load_high_score();
+        cached_high_score_loaded = true;
+    }
+    score_writer_start();
+
     game->score = 0;
-    game->high_score = score_load_high_score();
+    game->high_score = cached_high_score;
 }
 
 /******************************************************************************
@@ -72,31 +120,213 @@ int score_load_high_score(void) {
 }
 
 /******************************************************************************
- * @brief 保存历史最高分到文件
+ * @brief 原子地写入最高分文件
  * 
- * 将最高分写入 HIGHSCORE_FILE 文件
+ * 先写入同目录下本进程独有的临时文件并 fsync，再 rename 覆盖正式文件，
+ * 最后 fsync 目录。任何时刻崩溃，正式文件要么是旧内容，要么是新内容
+ * 
+ * @param score 要保存的分数
+ * @return bool 成功返回 true
+ *****************************************************************************/
+static bool score_write_file(int score) {
+    make_parent_dir(HIGHSCORE_FILE);
+
+    char temp_path[256];
+    snprintf(temp_path, sizeof(temp_path), "%s.%ld.tmp", HIGHSCORE_FILE, (long)getpid());
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    char text[32];
+    int length = snprintf(text, sizeof(text), "%d\n", score);
+    bool ok = write(fd, text, (size_t)length) == length && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(temp_path, HIGHSCORE_FILE) != 0) {
+        unlink(temp_path);
+        return false;
+    }
+
+    // Make the rename itself durable
+    char dir[256];
+    int dir_fd = get_parent_dir(HIGHSCORE_FILE, dir, sizeof(dir)) ? open(dir, O_RDONLY) : -1;
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief 后台写入线程：打开排行榜，然后等待待保存的分数和对局并写入文件
+ * 
+ * 停止时先写完仍在等待的分数和对局再退出
+ *****************************************************************************/
+static void* score_writer_main(void* arg) {
+    (void)arg;
+
+    if (!leaderboard) {
+        __atomic_store_n(&leaderboard, leaderboard_open(LEADERBOARD_FILE), __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_lock(&score_writer.lock);
+    for (;;) {
+        while (!score_writer.pending && score_writer.queue_count == 0 &&
+               !score_writer.stopping) {
+            pthread_cond_wait(&score_writer.wake, &score_writer.lock);
+        }
+
+        if (score_writer.queue_count > 0) {
+            leaderboard_record_t record = score_writer.queue[score_writer.queue_head];
+            score_writer.queue_head = (score_writer.queue_head + 1) % SCORE_QUEUE_SIZE;
+            score_writer.queue_count--;
+            pthread_mutex_unlock(&score_writer.lock);
+
+            leaderboard_submit(leaderboard, &record);
+
+            pthread_mutex_lock(&score_writer.lock);
+            continue;
+        }
+        if (!score_writer.pending) break;
+
+        int score = score_writer.pending_score;
+        score_writer.pending = false;
+        pthread_mutex_unlock(&score_writer.lock);
+
+        score_write_file(score);
+
+        pthread_mutex_lock(&score_writer.lock);
+    }
+    pthread_mutex_unlock(&score_writer.lock);
+    return NULL;
+}
+
+/******************************************************************************
+ * @brief 启动后台写入线程（已启动时不做任何事）
+ * 
+ * 创建失败时在调用线程打开排行榜，保存也退回到调用线程同步写入
+ *****************************************************************************/
+void score_writer_start(void) {
+    pthread_mutex_lock(&score_writer.lock);
+    if (!score_writer.started) {
+        score_writer.stopping = false;
+        score_writer.started =
+            pthread_create(&score_writer.thread, NULL, score_writer_main, NULL) == 0;
+        if (!score_writer.started && !leaderboard) {
+            __atomic_store_n(&leaderboard, leaderboard_open(LEADERBOARD_FILE), __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&score_writer.lock);
+}
+
+/******************************************************************************
+ * @brief 停止后台写入线程
+ * 
+ * 等待仍在排队的保存写完并关闭排行榜，程序退出前调用
+ *****************************************************************************/
+void score_shutdown(void) {
+    pthread_mutex_lock(&score_writer.lock);
+    bool started = score_writer.started;
+    score_writer.stopping = true;
+    pthread_cond_signal(&score_writer.wake);
+    pthread_mutex_unlock(&score_writer.lock);
+
+    if (started) {
+        pthread_join(score_writer.thread, NULL);
+    }
+    score_writer.started = false;
+
+    leaderboard_close(leaderboard);
+    __atomic_store_n(&leaderboard, NULL, __ATOMIC_RELEASE);
+}
+
+/******************************************************************************
+ * @brief 保存历史最高分
+ * 
+ * 立即更新缓存，文件由后台线程写入，调用者不会等待磁盘 I/O。
+ * 后台线程不可用时同步写入
  * 
  * @param score 要保存的分数
  *****************************************************************************/
 void score_save_high_score(int score) {
-    // create data dir on the first time
-    FILE* file = fopen(HIGHSCORE_FILE, "w");
-    if (!file) {
-        return; // Failed to open file for writing
+    if (score > cached_high_score) {
+        cached_high_score = score;
     }
 
-    fprintf(file, "%d\n", score);
-    fclose(file);
+    pthread_mutex_lock(&score_writer.lock);
+    bool queued = score_writer.started && !score_writer.stopping;
+    if (queued) {
+        if (!score_writer.pending || score > score_writer.pending_score) {
+            score_writer.pending_score = score;
+        }
+        score_writer.pending = true;
+        pthread_cond_signal(&score_writer.wake);
+    }
+    pthread_mutex_unlock(&score_writer.lock);
+
+    if (!queued) {
+        score_write_file(score);
+    }
+}
+
+/******************************************************************************
+ * @brief 提交一局的结果到排行榜
+ * 
+ * 由游戏实例填写记录：玩家名字取自 USER（或 LOGNAME），时长按
+ * 已运行的 tick 数乘以当前等级的移动间隔计算。记录交给后台线程写入
+ * （排行榜还没打开时由它打开后写入），调用者不会等待文件锁或磁盘 I/O。
+ * 后台线程不可用或队列已满时在调用线程同步写入
+ * 
+ * @param game 游戏实例指针
+ * @param record 输出参数 - 提交的记录，可为 NULL
+ *****************************************************************************/
+void score_submit_result(game_t* game, leaderboard_record_t* record) {
+    if (!game) return;
+
+    const char* name = getenv("USER");
+    if (!name || !*name) name = getenv("LOGNAME");
+
+    int speed_delay = game->level_config ? game->level_config->speed_delay : 0;
+    leaderboard_record_t result;
+    leaderboard_record_init(&result, name ? name : "player", game->level, game->score,
+                            game->snake ? game->snake->length : 0,
+                            (int64_t)game->tick_count * speed_delay, game->seed);
+    if (record) *record = result;
+
+    pthread_mutex_lock(&score_writer.lock);
+    bool queued = score_writer.started && !score_writer.stopping &&
+                  score_writer.queue_count < SCORE_QUEUE_SIZE;
+    if (queued) {
+        int tail = (score_writer.queue_head + score_writer.queue_count) % SCORE_QUEUE_SIZE;
+        score_writer.queue[tail] = result;
+        score_writer.queue_count++;
+        pthread_cond_signal(&score_writer.wake);
+    }
+    pthread_mutex_unlock(&score_writer.lock);
+
+    if (!queued) {
+        leaderboard_submit(__atomic_load_n(&leaderboard, __ATOMIC_ACQUIRE), &result);
+    }
+}
+
+/******************************************************************************
+ * @brief 获取共享排行榜
+ * 
+ * @return leaderboard_t* 排行榜指针，写入线程打开之前或文件不可用时为 NULL
+ *****************************************************************************/
+leaderboard_t* score_get_leaderboard(void) {
+    return __atomic_load_n(&leaderboard, __ATOMIC_ACQUIRE);
 }
 
 /******************************************************************************
  * @brief 检查是否为新的历史最高分
  * 
+ * 与缓存比较，不读文件
+ * 
  * @param score 要检查的分数
  * @return bool 是新最高分返回 true，否则返回 false
  *****************************************************************************/
 bool score_is_new_high_score(int score) {
-    return score > score_load_high_score();
+    return score > cached_high_score;
 }
 
 /******************************************************************************
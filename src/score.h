@@ -2,6 +2,7 @@
 #define SCORE_H
 
 #include "game.h"
+#include "leaderboard.h"
 
 // Score operations
 void score_init(game_t* game);
@@ -13,6 +14,14 @@ int score_load_high_score(void);
 void score_save_high_score(int score);
 bool score_is_new_high_score(int score);
 
+// Leaderboard, shared by every running game
+void score_submit_result(game_t* game, leaderboard_record_t* record);
+leaderboard_t* score_get_leaderboard(void);
+
+// Background writer, started by score_init
+void score_writer_start(void);
+void score_shutdown(void);
+
 // Score calculation
 int score_calculate_food_points(game_t* game, food_t* food);
 int score_get_level_multiplier(int level);
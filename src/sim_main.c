@@ -0,0 +1,340 @@
+#include "game.h"
+#include "snake.h"
+#include "headless.h"
+#include "replay.h"
+#include "env.h"
+#include "mcts.h"
+#include "sim_runner.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ * @brief 打印模拟器命令行用法
+ * 
+ * @param program 程序名
+ *****************************************************************************/
+static void sim_print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --games N        Number of games to simulate (default: 1)\n");
+    printf("  --ticks N        Tick limit per game, 0 for none (default: 0)\n");
+    printf("  --width W        Board width including border, %d to %d (default: 80)\n",
+           GAME_BOARD_MIN_SIZE, GAME_BOARD_MAX_SIZE);
+    printf("  --height H       Board height including border, %d to %d (default: 24)\n",
+           GAME_BOARD_MIN_SIZE, GAME_BOARD_MAX_SIZE);
+    printf("  --level L        Difficulty level 1-%d (default: 1)\n", get_max_levels());
+    printf("  --seed N         Random seed of the first game (default: clock)\n");
+    printf("  --record FILE    Record the simulated games as an input log\n");
+    printf("  --replay FILE    Replay an input log and verify every game\n");
+    printf("  --batch N        Step N games at once with the batch env API\n");
+    printf("  --threads N      Worker threads, 0 for one per CPU (default: 1)\n");
+    printf("  --autopilot      Steer with the path-finding autopilot\n");
+    printf("  --hamilton       Steer along a Hamiltonian cycle with shortcuts\n");
+    printf("  --mcts           Steer with a Monte Carlo tree search\n");
+    printf("  --mcts-threads N Tree search threads per game, 0 for one per CPU (default: 1)\n");
+    printf("  --mcts-rollouts N Tree search iterations per thread and tick (default: %d)\n",
+           MCTS_DEFAULT_ROLLOUTS);
+    printf("  --mcts-table BITS Share rollout results in a 2^BITS entry table (default: 0, none)\n");
+    printf("  --greedy         Steer to the food along an incremental distance field\n");
+    printf("  -h, --help       Show this help\n");
+}
+
+/******************************************************************************
+ * @brief 解析棋盘边长，范围与交互游戏相同
+ * 
+ * @param value 参数文本
+ * @param size 输出参数 - 边长（含边框）
+ * @return bool 在 GAME_BOARD_MIN_SIZE 到 GAME_BOARD_MAX_SIZE 之间返回 true
+ *****************************************************************************/
+static bool sim_parse_board_size(const char* value, int* size) {
+    char* end;
+    long parsed = strtol(value, &end, 10);
+    if (end == value || *end != '\0' ||
+        parsed < GAME_BOARD_MIN_SIZE || parsed > GAME_BOARD_MAX_SIZE) {
+        fprintf(stderr, "Invalid board size: %s (%d to %d)\n", value,
+                GAME_BOARD_MIN_SIZE, GAME_BOARD_MAX_SIZE);
+        return false;
+    }
+    *size = (int)parsed;
+    return true;
+}
+
+/******************************************************************************
+ * @brief 解析模拟器命令行参数
+ * 
+ * @param options 模拟设置指针
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @return bool 解析成功返回 true，否则返回 false
+ *****************************************************************************/
+static bool sim_parse_options(sim_options_t* options, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            return false;
+        } else if (strcmp(arg, "--games") == 0 && value) {
+            options->games = atoi(value);
+        } else if (strcmp(arg, "--ticks") == 0 && value) {
+            options->max_ticks = atol(value);
+        } else if (strcmp(arg, "--width") == 0 && value) {
+            if (!sim_parse_board_size(value, &options->width)) return false;
+        } else if (strcmp(arg, "--height") == 0 && value) {
+            if (!sim_parse_board_size(value, &options->height)) return false;
+        } else if (strcmp(arg, "--level") == 0 && value) {
+            options->level = atoi(value);
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            if (!options_parse_seed(value, &options->seed)) {
+                fprintf(stderr, "Invalid seed: %s\n", value);
+                return false;
+            }
+            options->has_seed = true;
+        } else if (strcmp(arg, "--record") == 0 && value) {
+            options->record_path = value;
+        } else if (strcmp(arg, "--replay") == 0 && value) {
+            options->replay_path = value;
+        } else if (strcmp(arg, "--batch") == 0 && value) {
+            options->batch = atoi(value);
+        } else if (strcmp(arg, "--autopilot") == 0) {
+            options->bot = BOT_AUTOPILOT;
+            continue;
+        } else if (strcmp(arg, "--hamilton") == 0) {
+            options->bot = BOT_HAMILTON;
+            continue;
+        } else if (strcmp(arg, "--mcts") == 0) {
+            options->bot = BOT_MCTS;
+            continue;
+        } else if (strcmp(arg, "--greedy") == 0) {
+            options->bot = BOT_GREEDY;
+            continue;
+        } else if (strcmp(arg, "--mcts-threads") == 0 && value) {
+            options->mcts_threads = atoi(value);
+        } else if (strcmp(arg, "--mcts-rollouts") == 0 && value) {
+            options->mcts_rollouts = atoi(value);
+        } else if (strcmp(arg, "--mcts-table") == 0 && value) {
+            options->mcts_table_bits = atoi(value);
+            if (options->mcts_table_bits < 0 || options->mcts_table_bits > TRANSPOSITION_MAX_BITS) {
+                fprintf(stderr, "Invalid table size: %s\n", value);
+                return false;
+            }
+        } else if (strcmp(arg, "--threads") == 0 && value) {
+            options->threads = atoi(value);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            return false;
+        }
+        i++;
+    }
+
+    return options->games > 0 && options->batch >= 0 && options->threads >= 0 && options->level >= 1 &&
+           options->level <= get_max_levels();
+}
+
+/******************************************************************************
+ * @brief 回放一局录制的游戏并校验结果
+ * 
+ * @param game 游戏实例指针
+ * @param player 回放器指针
+ * @return long 本局执行的节拍数
+ *****************************************************************************/
+static long sim_replay_game(game_t* game, replay_player_t* player) {
+    game->current_handler = get_headless_play_handler();
+    game->state = STATE_PLAYING;
+    game->next_state = STATE_PLAYING;
+
+    while (game->next_state == STATE_PLAYING &&
+           replay_player_step(player, game) == REPLAY_CONTINUE) {
+        game_update(game);
+    }
+
+    replay_player_check_end(player, game);
+    return game->tick_count;
+}
+
+/******************************************************************************
+ * @brief 以最快速度回放整个日志
+ * 
+ * @param path 日志文件路径
+ * @return int 退出码 - 所有对局与录制一致返回 0，否则返回 1
+ *****************************************************************************/
+static int sim_replay(const char* path) {
+    replay_player_t* player = replay_player_open(path);
+    if (!player) {
+        fprintf(stderr, "Cannot replay %s\n", path);
+        return 1;
+    }
+
+    game_t* game = game_create();
+    if (!game) {
+        fprintf(stderr, "Failed to create game!\n");
+        replay_player_close(player);
+        return 1;
+    }
+    game->renderer = get_headless_renderer();
+
+    long total_ticks = 0;
+    int64_t start = time_now_ns();
+
+    while (replay_player_begin_game(player, game)) {
+        total_ticks += sim_replay_game(game, player);
+    }
+
+    double seconds = (time_now_ns() - start) / 1e9;
+    if (seconds <= 0) seconds = 1e-9;
+
+    bool corrupt = player->pos < player->size;
+
+    printf("games:        %ld\n", player->games);
+    printf("ticks:        %ld\n", total_ticks);
+    printf("seconds:      %.3f\n", seconds);
+    printf("ticks/sec:    %.0f\n", total_ticks / seconds);
+    printf("mismatches:   %ld\n", player->mismatches);
+    if (corrupt) {
+        printf("corrupt log at byte %zu\n", player->pos);
+    }
+
+    int status = (player->mismatches > 0 || corrupt) ? 1 : 0;
+    replay_player_close(player);
+    game_destroy(game);
+    return status;
+}
+
+/******************************************************************************
+ * @brief 用批量环境模拟，直到完成指定局数
+ * 
+ * 每步为所有游戏随机选择动作，结束的游戏由环境自动重新开始
+ * 
+ * @param options 模拟设置指针
+ * @param seed 随机种子
+ * @return int 退出码 - 0 表示成功，1 表示失败
+ *****************************************************************************/
+static int sim_run_batch(const sim_options_t* options, uint64_t seed) {
+    snake_env_t* env = snake_env_create(options->batch, options->width,
+                                        options->height, seed);
+    uint8_t* actions = malloc((size_t)options->batch);
+    float* rewards = malloc(sizeof(float) * options->batch);
+    uint8_t* dones = malloc((size_t)options->batch);
+    if (!env || !actions || !rewards || !dones) {
+        fprintf(stderr, "Failed to create batch environment!\n");
+        snake_env_destroy(env);
+        free(actions);
+        free(rewards);
+        free(dones);
+        return 1;
+    }
+    env->max_steps = options->max_ticks;
+
+    rng_t steer_rng;
+    rng_seed(&steer_rng, rng_mix_seed(seed));
+
+    long total_steps = 0;
+    long total_food = 0;
+    int64_t start = time_now_ns();
+
+    while (env->episodes < options->games) {
+        for (int i = 0; i < options->batch; i++) {
+            actions[i] = (uint8_t)(rng_next(&steer_rng) >> 62);
+        }
+
+        snake_env_step(env, actions, rewards, dones);
+        total_steps += options->batch;
+
+        for (int i = 0; i < options->batch; i++) {
+            total_food += rewards[i] == SNAKE_ENV_REWARD_FOOD;
+        }
+    }
+
+    double seconds = (time_now_ns() - start) / 1e9;
+    if (seconds <= 0) seconds = 1e-9;
+
+    printf("batch:        %d\n", options->batch);
+    printf("games:        %ld\n", env->episodes);
+    printf("steps:        %ld\n", total_steps);
+    printf("seconds:      %.3f\n", seconds);
+    printf("steps/sec:    %.0f\n", total_steps / seconds);
+    printf("avg food:     %.2f\n", (double)total_food / env->episodes);
+
+    snake_env_destroy(env);
+    free(actions);
+    free(rewards);
+    free(dones);
+    return 0;
+}
+
+/******************************************************************************
+ * @brief 无终端模拟器入口
+ * 
+ * 不依赖 ncurses，连续模拟多局游戏并报告吞吐量和平均成绩
+ * 
+ * @param argc 参数个数
+ * @param argv 参数数组
+ * @return int 退出码 - 0 表示成功，1 表示失败
+ *****************************************************************************/
+int main(int argc, char** argv) {
+    sim_options_t options = {
+        .games = 1,
+        .max_ticks = 0,
+        .width = 80,
+        .height = 24,
+        .level = 1,
+        .has_seed = false,
+        .seed = 0,
+        .record_path = NULL,
+        .replay_path = NULL,
+        .batch = 0,
+        .threads = 1,
+        .bot = BOT_NONE,
+        .mcts_threads = 1,
+        .mcts_rollouts = 0,
+        .mcts_table_bits = 0
+    };
+
+    if (!sim_parse_options(&options, argc, argv)) {
+        sim_print_usage(argv[0]);
+        return 1;
+    }
+
+    uint64_t seed = options.has_seed ? options.seed : rng_seed_from_clock();
+
+    if (options.batch > 0) {
+        return sim_run_batch(&options, seed);
+    }
+
+    if (options.replay_path) {
+        return sim_replay(options.replay_path);
+    }
+
+    sim_stats_t stats;
+    int64_t start = time_now_ns();
+
+    if (!sim_run_games(&options, seed, &stats)) {
+        fprintf(stderr, "Simulation failed!\n");
+        return 1;
+    }
+
+    double seconds = (time_now_ns() - start) / 1e9;
+    if (seconds <= 0) seconds = 1e-9;
+
+    printf("threads:      %d\n", sim_thread_count(&options));
+    printf("games:        %ld\n", stats.games);
+    printf("ticks:        %ld\n", stats.ticks);
+    printf("seconds:      %.3f\n", seconds);
+    printf("ticks/sec:    %.0f\n", stats.ticks / seconds);
+    printf("games/sec:    %.1f\n", stats.games / seconds);
+    printf("avg score:    %.1f\n", (double)stats.score / stats.games);
+    printf("avg length:   %.1f\n", (double)stats.length / stats.games);
+    printf("wins:         %ld\n", stats.wins);
+    printf("stalled:      %ld\n", stats.stalls);
+    printf("steals:       %ld\n", stats.steals);
+    if (stats.rollouts > 0) {
+        printf("rollouts:     %ld\n", stats.rollouts);
+        printf("rollouts/sec: %.0f\n", stats.rollouts / seconds);
+    }
+    if (stats.table_probes > 0) {
+        printf("table hits:   %.1f%%\n", 100.0 * stats.table_hits / stats.table_probes);
+    }
+
+    return 0;
+}
@@ -0,0 +1,361 @@
+#define _POSIX_C_SOURCE 200809L
+#include "sim_runner.h"
+#include "game.h"
+#include "snake.h"
+#include "headless.h"
+#include "replay.h"
+#include "mcts.h"
+#include "utils.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SIM_CACHE_LINE 64
+
+// A worker's share of the games as one packed word: next game in the high
+// half, one past the last game in the low half. Owner and thieves update
+// it with a single compare-and-swap, so no locks are needed.
+#define SIM_RANGE(next, end) (((uint64_t)(next) << 32) | (uint32_t)(end))
+#define SIM_RANGE_NEXT(range) ((uint32_t)((range) >> 32))
+#define SIM_RANGE_END(range) ((uint32_t)(range))
+
+typedef struct sim_pool sim_pool_t;
+
+// Worker thread state, aligned to whole cache lines so the queue word
+// thieves hammer never shares a line with any worker's counters
+typedef struct {
+    uint64_t range;
+    char queue_padding[SIM_CACHE_LINE - sizeof(uint64_t)];
+
+    int id;
+    pthread_t thread;
+    sim_pool_t* pool;
+    sim_stats_t stats;      // Written only by this worker, summed after join
+    bool failed;
+} __attribute__((aligned(SIM_CACHE_LINE))) sim_worker_t;
+
+struct sim_pool {
+    const sim_options_t* options;
+    uint64_t seed;
+    int count;
+    sim_worker_t* workers;
+};
+
+/******************************************************************************
+ * @brief 计算第 index 局的种子
+ * 
+ * 取种子为 seed 的 SplitMix64 序列的第 index 个输出，
+ * 每局的种子只取决于序号，与线程数和执行顺序无关
+ * 
+ * @param seed 基础种子
+ * @param index 对局序号
+ * @return uint64_t 该局种子
+ *****************************************************************************/
+uint64_t sim_game_seed(uint64_t seed, long index) {
+    return rng_mix_seed(seed + (uint64_t)index * 0x9E3779B97F4A7C15ULL);
+}
+
+/******************************************************************************
+ * @brief 计算实际使用的工作线程数
+ * 
+ * @param options 模拟设置指针
+ * @return int 线程数，至少为 1，且不超过局数
+ *****************************************************************************/
+int sim_thread_count(const sim_options_t* options) {
+    int threads = options->threads;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > options->games) threads = options->games;
+    return threads < 1 ? 1 : threads;
+}
+
+/******************************************************************************
+ * @brief 检查蛇头朝指定方向移动一步是否安全
+ * 
+ * @param game 游戏实例指针
+ * @param dir 移动方向
+ * @return bool 不会撞墙或撞到自身返回 true
+ *****************************************************************************/
+static bool sim_is_safe_move(game_t* game, direction_t dir) {
+    point_t next = point_add(snake_get_head_position(game->snake), direction_to_point(dir));
+
+    return game_is_point_in_bounds(game, next) &&
+           !game_is_point_on_border(game, next) &&
+           !snake_contains_point(game->snake, next);
+}
+
+/******************************************************************************
+ * @brief 随机漫步控制：在安全的方向中随机选择一个
+ * 
+ * 使用独立的随机数生成器，不消耗游戏自身的随机序列，
+ * 这样回放时不需要重新执行控制逻辑也能得到相同的食物位置
+ * 
+ * @param game 游戏实例指针
+ * @param rng 控制器随机数生成器
+ *****************************************************************************/
+static void sim_steer_random(game_t* game, rng_t* rng) {
+    direction_t current = game->snake->direction;
+    direction_t candidates[3];
+    int count = 0;
+
+    for (int dir = DIR_UP; dir <= DIR_RIGHT; dir++) {
+        if ((direction_t)dir != opposite_direction(current) &&
+            sim_is_safe_move(game, (direction_t)dir)) {
+            candidates[count++] = (direction_t)dir;
+        }
+    }
+
+    if (count > 0) {
+        snake_set_direction(game->snake, candidates[rng_range(rng, 0, count - 1)]);
+    }
+}
+
+/******************************************************************************
+ * @brief 模拟一局游戏直到蛇死亡、占满棋盘、停滞或达到节拍上限
+ * 
+ * 通过无终端状态处理器走完整的 game_update 流程。
+ * 设置了游戏控制器（自动驾驶）时由它转向，否则随机漫步。
+ * 游戏和控制器的随机数都由本局种子决定。
+ * 连续 SIM_STALL_TICKS_PER_CELL 倍棋盘格子数的节拍没有吃到食物时
+ * 视为停滞（控制器原地绕圈），提前结束本局
+ * 
+ * @param game 游戏实例指针
+ * @param options 模拟设置指针
+ * @param seed 本局种子
+ * @param stalled 输出参数 - 本局因停滞而结束时为 true
+ * @return long 本局执行的节拍数
+ *****************************************************************************/
+static long sim_play_game(game_t* game, const sim_options_t* options, uint64_t seed,
+                          bool* stalled) {
+    rng_t steer_rng;
+    rng_seed(&steer_rng, rng_mix_seed(seed));
+
+    game_set_seed(game, seed);
+    game_change_level(game, options->level);
+    game->current_handler = get_headless_play_handler();
+    game->state = STATE_PLAYING;
+    game->next_state = STATE_PLAYING;
+
+    long stall_limit = SIM_STALL_TICKS_PER_CELL * (long)game->board_width * game->board_height;
+    long ticks = 0;
+    long last_food = 0;
+    int last_score = game->score;
+    *stalled = false;
+
+    while (game->next_state == STATE_PLAYING && game->snake &&
+           (options->max_ticks == 0 || ticks < options->max_ticks)) {
+        if (ticks - last_food >= stall_limit) {
+            *stalled = true;
+            break;
+        }
+        if (!game->controller) {
+            sim_steer_random(game, &steer_rng);
+        }
+        game_update(game);
+        ticks++;
+
+        if (game->score != last_score) {
+            last_score = game->score;
+            last_food = ticks;
+        }
+    }
+
+    return ticks;
+}
+
+/******************************************************************************
+ * @brief 从自己的区间头部取一局
+ * 
+ * @param worker 工作线程指针
+ * @param index 输出对局序号
+ * @return bool 成功返回 true，区间为空返回 false
+ *****************************************************************************/
+static bool sim_worker_pop(sim_worker_t* worker, long* index) {
+    uint64_t range = __atomic_load_n(&worker->range, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        uint32_t next = SIM_RANGE_NEXT(range);
+        uint32_t end = SIM_RANGE_END(range);
+        if (next >= end) return false;
+
+        if (__atomic_compare_exchange_n(&worker->range, &range, SIM_RANGE(next + 1, end),
+                                        true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = next;
+            return true;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief 从其他线程的区间尾部窃取一半
+ * 
+ * 依次尝试其他线程，窃取到的区间放入自己的队列，第一局直接返回
+ * 
+ * @param worker 工作线程指针
+ * @param index 输出对局序号
+ * @return bool 成功返回 true，所有线程都没有剩余对局返回 false
+ *****************************************************************************/
+static bool sim_worker_steal(sim_worker_t* worker, long* index) {
+    sim_pool_t* pool = worker->pool;
+
+    for (int i = 1; i < pool->count; i++) {
+        sim_worker_t* victim = &pool->workers[(worker->id + i) % pool->count];
+        uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+        for (;;) {
+            uint32_t next = SIM_RANGE_NEXT(range);
+            uint32_t end = SIM_RANGE_END(range);
+            if (next >= end) break;
+
+            uint32_t mid = end - (end - next + 1) / 2;
+            if (__atomic_compare_exchange_n(&victim->range, &range, SIM_RANGE(next, mid),
+                                            true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                __atomic_store_n(&worker->range, SIM_RANGE(mid + 1, end), __ATOMIC_RELEASE);
+                worker->stats.steals++;
+                *index = mid;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/******************************************************************************
+ * @brief 工作线程主函数
+ * 
+ * 复用一个游戏实例依次模拟分到的对局，自己的区间取完后窃取其他线程的，
+ * 全部取完后退出
+ * 
+ * @param arg 工作线程指针
+ * @return void* 始终返回 NULL
+ *****************************************************************************/
+static void* sim_worker_main(void* arg) {
+    sim_worker_t* worker = arg;
+    const sim_options_t* options = worker->pool->options;
+
+    game_t* game = game_create();
+    if (!game) {
+        worker->failed = true;
+        return NULL;
+    }
+    game->renderer = get_headless_renderer();
+    game_set_board_size(game, options->width, options->height);
+    game->controller = get_bot_controller(options->bot);
+    game->options.mcts_threads = options->mcts_threads;
+    game->options.mcts_rollouts = options->mcts_rollouts;
+    game->options.mcts_table_bits = options->mcts_table_bits;
+
+    // Recording needs the games in order, sim_run_games allows it with one worker only
+    if (options->record_path) {
+        game->recorder = replay_recorder_open(options->record_path);
+        if (!game->recorder) {
+            fprintf(stderr, "Cannot record to %s\n", options->record_path);
+            worker->failed = true;
+            game_destroy(game);
+            return NULL;
+        }
+    }
+
+    long index;
+    while (sim_worker_pop(worker, &index) || sim_worker_steal(worker, &index)) {
+        bool stalled;
+        worker->stats.ticks += sim_play_game(game, options,
+                                             sim_game_seed(worker->pool->seed, index), &stalled);
+        worker->stats.games++;
+        worker->stats.stalls += stalled ? 1 : 0;
+        worker->stats.score += game->score;
+        worker->stats.length += game->snake ? game->snake->length : 0;
+        worker->stats.wins += game->won ? 1 : 0;
+    }
+    if (game->mcts) {
+        worker->stats.rollouts = game->mcts->total_rollouts;
+        worker->stats.table_probes = game->mcts->table_probes;
+        worker->stats.table_hits = game->mcts->table_hits;
+    }
+
+    game_destroy(game);
+    return NULL;
+}
+
+/******************************************************************************
+ * @brief 用线程池模拟所有对局
+ * 
+ * 对局按序号均分给各工作线程，线程取完自己的部分后从其他线程窃取，
+ * 以平衡长度差异很大的对局。每个线程只写自己的统计，结束后汇总。
+ * 每局的种子只取决于序号，因此结果与线程数无关
+ * 
+ * @param options 模拟设置指针
+ * @param seed 基础种子
+ * @param stats 输出汇总统计
+ * @return bool 成功返回 true，否则返回 false
+ *****************************************************************************/
+bool sim_run_games(const sim_options_t* options, uint64_t seed, sim_stats_t* stats) {
+    if (!options || !stats) return false;
+
+    int count = sim_thread_count(options);
+    if (options->record_path && count > 1) {
+        fprintf(stderr, "--record needs a single thread\n");
+        return false;
+    }
+
+    void* memory = NULL;
+    if (posix_memalign(&memory, SIM_CACHE_LINE, sizeof(sim_worker_t) * count) != 0) {
+        return false;
+    }
+
+    sim_pool_t pool = {
+        .options = options,
+        .seed = seed,
+        .count = count,
+        .workers = memory
+    };
+    memset(pool.workers, 0, sizeof(sim_worker_t) * count);
+
+    for (int i = 0; i < count; i++) {
+        sim_worker_t* worker = &pool.workers[i];
+        long start = (long)options->games * i / count;
+        long end = (long)options->games * (i + 1) / count;
+
+        worker->range = SIM_RANGE(start, end);
+        worker->id = i;
+        worker->pool = &pool;
+    }
+
+    // Worker 0 runs on the calling thread
+    int started = 1;
+    for (int i = 1; i < count; i++, started++) {
+        if (pthread_create(&pool.workers[i].thread, NULL, sim_worker_main, &pool.workers[i]) != 0) {
+            break; // Games of workers that failed to start get stolen by the others
+        }
+    }
+    sim_worker_main(&pool.workers[0]);
+
+    memset(stats, 0, sizeof(*stats));
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        sim_worker_t* worker = &pool.workers[i];
+        if (i > 0 && i < started) {
+            pthread_join(worker->thread, NULL);
+        }
+
+        ok = ok && !worker->failed;
+        stats->games += worker->stats.games;
+        stats->ticks += worker->stats.ticks;
+        stats->score += worker->stats.score;
+        stats->length += worker->stats.length;
+        stats->wins += worker->stats.wins;
+        stats->stalls += worker->stats.stalls;
+        stats->steals += worker->stats.steals;
+        stats->rollouts += worker->stats.rollouts;
+        stats->table_probes += worker->stats.table_probes;
+        stats->table_hits += worker->stats.table_hits;
+    }
+
+    free(memory);
+    return ok && stats->games == options->games;
+}
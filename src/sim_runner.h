@@ -0,0 +1,51 @@
+#ifndef SIM_RUNNER_H
+#define SIM_RUNNER_H
+
+#include "options.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// A game that goes this many ticks per board cell without eating is
+// stopped as stalled: the controller is circling and will never finish.
+// A random walk finds the food well within this.
+#define SIM_STALL_TICKS_PER_CELL    64
+
+// Simulation settings
+typedef struct {
+    int games;
+    long max_ticks;         // Tick limit per game, 0 for no limit
+    int width;
+    int height;
+    int level;
+    bool has_seed;
+    uint64_t seed;
+    const char* record_path;    // Record the simulated games to this file
+    const char* replay_path;    // Verify the games recorded in this file
+    int batch;                  // Step this many games at once through snake_env, 0 for off
+    int threads;                // Worker threads, 0 for one per online CPU
+    bot_mode_t bot;             // Computer player, BOT_NONE for a random walk
+    int mcts_threads;           // Tree search threads per game, 0 for one per online CPU
+    int mcts_rollouts;          // Tree search iterations per thread and tick, 0 for default
+    int mcts_table_bits;        // Log2 of the tree search transposition table size, 0 for none
+} sim_options_t;
+
+// Totals over a set of simulated games
+typedef struct {
+    long games;
+    long ticks;
+    long score;
+    long length;            // Sum of final snake lengths
+    long wins;              // Games that ended with the board full
+    long stalls;            // Games stopped for going too long without food
+    long steals;            // Game ranges taken from another worker
+    long rollouts;          // Tree search iterations
+    long table_probes;      // Tree search leaves looked up in the transposition table
+    long table_hits;        // Tree search leaves that reused a stored value
+} sim_stats_t;
+
+// Runner
+uint64_t sim_game_seed(uint64_t seed, long index);
+int sim_thread_count(const sim_options_t* options);
+bool sim_run_games(const sim_options_t* options, uint64_t seed, sim_stats_t* stats);
+
+#endif // SIM_RUNNER_H
@@ -1,7 +1,21 @@
 #include "snake.h"
+#include "grid.h"
+#include "zobrist.h"
 #include <stdlib.h>
 #include <string.h>
 
+/******************************************************************************
+ * @brief 计算第 i 个蛇身段在环形缓冲区中的下标
+ * 
+ * @param snake 蛇实例指针
+ * @param i 蛇身段序号，0 表示头部
+ * @return int 环形缓冲区下标
+ *****************************************************************************/
+static inline int snake_ring_index(const snake_t* snake, int i) {
+    int index = snake->head_index - i;
+    return index < 0 ? index + snake->capacity : index;
+}
+
 // Static behavior instance
 static snake_behavior_t normal_behavior = {
     .move_snake = snake_move_normal,
@@ -12,66 +26,67 @@ static snake_behavior_t normal_behavior = {
 /******************************************************************************
  * @brief 创建蛇实例
  * 
- * 在指定位置创建蛇，初始长度为 1，方向为指定方向
+ * 在指定位置创建蛇，初始长度为 1，方向为指定方向。
+ * 蛇身环形缓冲区一次性按最大长度分配，移动过程中不再分配内存
  * 
  * @param start_x 起始 X 坐标
  * @param start_y 起始 Y 坐标
  * @param initial_dir 初始方向
+ * @param capacity 蛇的最大长度（通常为棋盘格子数）
+ * @param arena 内存池，NULL 表示从堆上分配
  * @return snake_t* 蛇实例指针，失败返回 NULL
  *****************************************************************************/
-snake_t* snake_create(int start_x, int start_y, direction_t initial_dir) {
-    snake_t* snake = malloc(sizeof(snake_t));
+snake_t* snake_create(int start_x, int start_y, direction_t initial_dir, int capacity,
+                      arena_t* arena) {
+    if (capacity < 1) capacity = 1;
+
+    snake_t* snake = arena_alloc(arena, sizeof(snake_t));
     if (!snake) return NULL;
 
-    // Create initial head segment
-    snake_segment_t* head = malloc(sizeof(snake_segment_t));
-    if (!head) {
-        free(snake);
+    // Preallocate the body ring buffer
+    snake->body = arena_alloc(arena, sizeof(point_t) * capacity);
+    if (!snake->body) {
+        arena_free(arena, snake);
         return NULL;
     }
 
-    head->position = point_create(start_x, start_y);
-    head->next = NULL;
-
-    snake->head = head;
-    snake->tail = head;
+    snake->capacity = capacity;
+    snake->head_index = 0;
+    snake->body[0] = point_create(start_x, start_y);
     snake->direction = initial_dir;
-    snake->next_direction = initial_dir;
+    snake->turn_queue_start = 0;
+    snake->turn_queue_count = 0;
     snake->length = 1;
     snake->behavior = &normal_behavior;
     snake->should_grow = false;
+    snake->grid = NULL;
+    snake->arena = arena;
+    snake->hash = zobrist_key(ZOBRIST_BODY, start_x, start_y) ^
+                  zobrist_key(ZOBRIST_HEAD, start_x, start_y);
 
     return snake;
 }
 
 /******************************************************************************
- * @brief 销毁蛇实例并释放所有蛇身段
- * 
- * 遍历链表释放所有蛇身段，最后释放蛇结构体本身
+ * @brief 销毁蛇实例并释放蛇身缓冲区
  * 
  * @param snake 蛇实例指针
  *****************************************************************************/
 void snake_destroy(snake_t* snake) {
     if (!snake) return;
 
-    snake_segment_t* current = snake->head;
-    while (current) {
-        snake_segment_t* next = current->next;
-        free(current);
-        current = next;
-    }
-
-    free(snake);
+    arena_free(snake->arena, snake->body);
+    arena_free(snake->arena, snake);
 }
 
 /******************************************************************************
  * @brief 蛇的正常移动行为
  * 
  * 根据当前方向移动蛇：
- * 1. 更新方向（防止立即反向）
+ * 1. 从转向队列中取出一个转向作为新方向
  * 2. 计算新头部位置
- * 3. 创建新头部段
- * 4. 如果不生长则移除尾部
+ * 3. 如果不生长（或缓冲区已满）则移除尾部
+ * 4. 在环形缓冲区中压入新头部（O(1)，无内存分配）
  * 
  * @param snake 蛇实例指针
  * @param game 游戏实例指针
@@ -79,30 +94,44 @@ void snake_destroy(snake_t* snake) {
 void snake_move_normal(snake_t* snake, game_t* game) {
     if (!snake || !game) return;
 
-    // Update direction (prevent immediate reversal)
-    if (snake->next_direction != opposite_direction(snake->direction)) {
-        snake->direction = snake->next_direction;
+    // Consume one queued turn (prevent immediate reversal)
+    if (snake->turn_queue_count > 0) {
+        direction_t turn = snake->turn_queue[snake->turn_queue_start];
+        snake->turn_queue_start = (snake->turn_queue_start + 1) % SNAKE_TURN_QUEUE_SIZE;
+        snake->turn_queue_count--;
+
+        if (turn != opposite_direction(snake->direction)) {
+            snake->direction = turn;
+        }
     }
 
     // Calculate new head position
     point_t movement = direction_to_point(snake->direction);
-    point_t new_head_pos = point_add(snake->head->position, movement);
-
-    // Create new head segment
-    snake_segment_t* new_head = malloc(sizeof(snake_segment_t));
-    if (!new_head) return; // Memory allocation failed
-
-    new_head->position = new_head_pos;
-    new_head->next = snake->head;
-    snake->head = new_head;
-    snake->length++;
+    point_t old_head_pos = snake_get_head_position(snake);
+    point_t new_head_pos = point_add(old_head_pos, movement);
+
+    // Drop tail unless growing (a full ring buffer or a snake covering the
+    // whole board cannot grow any further).
+    // Popping before the push frees the slot the new head may reuse.
+    if (!snake->should_grow || snake->length >= snake->capacity ||
+        (snake->grid && grid_free_count(snake->grid) == 0)) {
+        point_t tail_pos = snake_get_tail_position(snake);
+        grid_vacate(snake->grid, tail_pos);
+        snake->hash ^= zobrist_point_key(ZOBRIST_BODY, tail_pos);
+        snake->length--;
+    }
+    snake->should_grow = false;
 
-    // Remove tail unless growing
-    if (!snake->should_grow) {
-        snake_remove_tail(snake);
-    } else {
-        snake->should_grow = false;
+    // Push new head
+    if (++snake->head_index == snake->capacity) {
+        snake->head_index = 0;
     }
+    snake->body[snake->head_index] = new_head_pos;
+    snake->length++;
+    grid_occupy(snake->grid, new_head_pos);
+    snake->hash ^= zobrist_point_key(ZOBRIST_HEAD, old_head_pos) ^
+                   zobrist_point_key(ZOBRIST_HEAD, new_head_pos) ^
+                   zobrist_point_key(ZOBRIST_BODY, new_head_pos);
 }
 
 /******************************************************************************
@@ -127,16 +156,8 @@ bool snake_check_collision_normal(snake_t* snake, game_t* game) {
         return true;
     }
 
-    // Check self collision (skip head when checking)
-    snake_segment_t* current = snake->head->next;
-    while (current) {
-        if (point_equals(head_pos, current->position)) {
-            return true;
-        }
-        current = current->next;
-    }
-
-    return false;
+    // Check self collision
+    return snake_head_collides_with_body(snake);
 }
 
 /******************************************************************************
@@ -154,73 +175,76 @@ void snake_grow_normal(snake_t* snake) {
 /******************************************************************************
  * @brief 设置蛇的移动方向
  * 
- * 设置下一个方向，实际方向更新在移动时进行（防止立即反向）
+ * 将转向加入转向队列，每次移动消耗一个，实际方向更新在移动时进行。
+ * 转向根据蛇到那时将具有的方向（队列中最后一个转向）进行校验：
+ * 与其相同或相反的转向被忽略，因此同一节拍内的连续转向
+ * （如向上后立即向左完成掉头）都能依次生效。队列满时忽略新的转向
  * 
  * @param snake 蛇实例指针
  * @param new_dir 新方向
  *****************************************************************************/
 void snake_set_direction(snake_t* snake, direction_t new_dir) {
+    if (!snake || snake->turn_queue_count >= SNAKE_TURN_QUEUE_SIZE) return;
+
+    // Direction the snake will have once all queued turns are applied
+    direction_t planned = snake->direction;
+    if (snake->turn_queue_count > 0) {
+        int last = (snake->turn_queue_start + snake->turn_queue_count - 1) % SNAKE_TURN_QUEUE_SIZE;
+        planned = snake->turn_queue[last];
+    }
+
+    if (new_dir == planned || new_dir == opposite_direction(planned)) {
+        return;
+    }
+
+    int slot = (snake->turn_queue_start + snake->turn_queue_count) % SNAKE_TURN_QUEUE_SIZE;
+    snake->turn_queue[slot] = new_dir;
+    snake->turn_queue_count++;
+}
+
+/******************************************************************************
+ * @brief 清空转向队列
+ * 
+ * @param snake 蛇实例指针
+ *****************************************************************************/
+void snake_clear_turns(snake_t* snake) {
     if (!snake) return;
-    snake->next_direction = new_dir;
+
+    snake->turn_queue_start = 0;
+    snake->turn_queue_count = 0;
 }
 
 /******************************************************************************
  * @brief 添加蛇身段
  * 
- * 在蛇尾部添加一个新的身体段
+ * 在蛇尾部添加一个新的身体段，缓冲区已满时忽略
  * 
  * @param snake 蛇实例指针
  * @param position 新段的位置
  *****************************************************************************/
 void snake_add_segment(snake_t* snake, point_t position) {
-    if (!snake) return;
-
-    snake_segment_t* new_segment = malloc(sizeof(snake_segment_t));
-    if (!new_segment) return;
-
-    new_segment->position = position;
-    new_segment->next = NULL;
-
-    if (snake->tail) {
-        snake->tail->next = new_segment;
-    }
-    snake->tail = new_segment;
-
-    if (!snake->head) {
-        snake->head = new_segment;
-    }
+    if (!snake || snake->length >= snake->capacity) return;
 
+    snake->body[snake_ring_index(snake, snake->length)] = position;
     snake->length++;
+    grid_occupy(snake->grid, position);
+    snake->hash ^= zobrist_point_key(ZOBRIST_BODY, position);
 }
 
 /******************************************************************************
  * @brief 移除蛇尾部
  * 
- * 移除蛇的最后一个身体段，用于正常移动时保持长度不变
+ * 移除蛇的最后一个身体段，用于正常移动时保持长度不变。
+ * 尾部由头部下标和长度推算，只需减少长度即可（O(1)）
  * 
  * @param snake 蛇实例指针
  *****************************************************************************/
 void snake_remove_tail(snake_t* snake) {
-    if (!snake || !snake->head || snake->length <= 1) return;
-
-    if (snake->length == 1) {
-        free(snake->head);
-        snake->head = NULL;
-        snake->tail = NULL;
-        snake->length = 0;
-        return;
-    }
-
-    // Find second-to-last segment
-    snake_segment_t* current = snake->head;
-    while (current->next && current->next != snake->tail) {
-        current = current->next;
-    }
+    if (!snake || snake->length <= 1) return;
 
-    // Remove tail
-    free(snake->tail);
-    snake->tail = current;
-    current->next = NULL;
+    point_t tail_pos = snake_get_tail_position(snake);
+    grid_vacate(snake->grid, tail_pos);
+    snake->hash ^= zobrist_point_key(ZOBRIST_BODY, tail_pos);
     snake->length--;
 }
 
@@ -237,22 +261,40 @@ void snake_remove_tail(snake_t* snake) {
 void snake_reset_position(snake_t* snake, int x, int y, direction_t dir) {
     if (!snake) return;
 
-    // Clear existing segments except head
-    snake_segment_t* current = snake->head->next;
-    while (current) {
-        snake_segment_t* next = current->next;
-        free(current);
-        current = next;
-    }
-
     // Reset head
-    snake->head->position = point_create(x, y);
-    snake->head->next = NULL;
-    snake->tail = snake->head;
+    snake->head_index = 0;
+    snake->body[0] = point_create(x, y);
     snake->direction = dir;
-    snake->next_direction = dir;
+    snake_clear_turns(snake);
     snake->length = 1;
     snake->should_grow = false;
+    snake->hash = zobrist_key(ZOBRIST_BODY, x, y) ^ zobrist_key(ZOBRIST_HEAD, x, y);
+
+    if (snake->grid) {
+        grid_clear(snake->grid);
+        grid_occupy(snake->grid, snake->body[0]);
+    }
+}
+
+/******************************************************************************
+ * @brief 将占用网格关联到蛇
+ * 
+ * 清空网格并标记当前所有蛇身段，之后网格随蛇头压入、蛇尾弹出增量更新，
+ * 使碰撞和包含查询变为 O(1)
+ * 
+ * @param snake 蛇实例指针
+ * @param grid 网格实例指针，NULL 表示取消关联
+ *****************************************************************************/
+void snake_attach_grid(snake_t* snake, grid_t* grid) {
+    if (!snake) return;
+
+    snake->grid = grid;
+    if (!grid) return;
+
+    grid_clear(grid);
+    for (int i = 0; i < snake->length; i++) {
+        grid_occupy(grid, snake->body[snake_ring_index(snake, i)]);
+    }
 }
 
 /******************************************************************************
@@ -262,16 +304,45 @@ void snake_reset_position(snake_t* snake, int x, int y, direction_t dir) {
  * @return point_t 头部位置坐标
  *****************************************************************************/
 point_t snake_get_head_position(snake_t* snake) {
-    if (!snake || !snake->head) {
+    if (!snake || snake->length < 1) {
         return point_create(0, 0);
     }
-    return snake->head->position;
+    return snake->body[snake->head_index];
+}
+
+/******************************************************************************
+ * @brief 获取蛇尾部位置
+ * 
+ * @param snake 蛇实例指针
+ * @return point_t 尾部位置坐标
+ *****************************************************************************/
+point_t snake_get_tail_position(snake_t* snake) {
+    if (!snake || snake->length < 1) {
+        return point_create(0, 0);
+    }
+    return snake->body[snake_ring_index(snake, snake->length - 1)];
+}
+
+/******************************************************************************
+ * @brief 获取指定序号的蛇身段位置
+ * 
+ * 用于遍历蛇身：序号 0 为头部，length - 1 为尾部
+ * 
+ * @param snake 蛇实例指针
+ * @param index 蛇身段序号
+ * @return point_t 该段位置坐标，序号无效返回 (0, 0)
+ *****************************************************************************/
+point_t snake_get_segment(snake_t* snake, int index) {
+    if (!snake || index < 0 || index >= snake->length) {
+        return point_create(0, 0);
+    }
+    return snake->body[snake_ring_index(snake, index)];
 }
 
 /******************************************************************************
  * @brief 检查蛇是否包含指定点
  * 
- * 遍历蛇的所有身体段，检查是否有任何段在指定位置
+ * 关联了占用网格时直接查表（O(1)），否则遍历所有身体段
  * 
  * @param snake 蛇实例指针
  * @param point 要检查的点
@@ -280,12 +351,14 @@ point_t snake_get_head_position(snake_t* snake) {
 bool snake_contains_point(snake_t* snake, point_t point) {
     if (!snake) return false;
 
-    snake_segment_t* current = snake->head;
-    while (current) {
-        if (point_equals(current->position, point)) {
+    if (snake->grid) {
+        return grid_is_occupied(snake->grid, point);
+    }
+
+    for (int i = 0; i < snake->length; i++) {
+        if (point_equals(snake->body[snake_ring_index(snake, i)], point)) {
             return true;
         }
-        current = current->next;
     }
 
     return false;
@@ -294,24 +367,27 @@ bool snake_contains_point(snake_t* snake, point_t point) {
 /******************************************************************************
  * @brief 检查蛇头是否与身体碰撞
  * 
- * 检查蛇头部位置是否与任何身体段重叠
+ * 检查蛇头部位置是否与任何身体段重叠。关联了占用网格时，
+ * 头部所在格子的占用次数大于 1 即表示重叠（O(1)）
  * 
  * @param snake 蛇实例指针
  * @return bool 发生碰撞返回 true，否则返回 false
  *****************************************************************************/
 bool snake_head_collides_with_body(snake_t* snake) {
-    if (!snake || !snake->head || !snake->head->next) {
+    if (!snake || snake->length < 2) {
         return false;
     }
 
-    point_t head_pos = snake->head->position;
-    snake_segment_t* current = snake->head->next;
+    point_t head_pos = snake->body[snake->head_index];
+
+    if (snake->grid) {
+        return grid_get_count(snake->grid, head_pos) > 1;
+    }
 
-    while (current) {
-        if (point_equals(head_pos, current->position)) {
+    for (int i = 1; i < snake->length; i++) {
+        if (point_equals(head_pos, snake->body[snake_ring_index(snake, i)])) {
             return true;
         }
-        current = current->next;
     }
 
     return false;
@@ -3,27 +3,35 @@
 
 #include "game.h"
 #include "utils.h"
+#include "arena.h"
 #include <stdbool.h>
+#include <stdint.h>
 
-// Snake segment structure
-typedef struct snake_segment {
-    point_t position;
-    struct snake_segment* next;
-} snake_segment_t;
+// Maximum number of turns buffered between two ticks
+#define SNAKE_TURN_QUEUE_SIZE 4
 
 // Snake structure
+// Body segments live in a preallocated ring buffer: the head is stored at
+// head_index and segment i (0 = head) at head_index - i, wrapping around.
 struct snake {
-    snake_segment_t* head;
-    snake_segment_t* tail;
+    point_t* body;          // Ring buffer of segment positions
+    int capacity;           // Ring buffer size (maximum snake length)
+    int head_index;         // Ring buffer index of the head segment
     direction_t direction;
-    direction_t next_direction;
+    direction_t turn_queue[SNAKE_TURN_QUEUE_SIZE]; // Pending turns, one consumed per tick
+    int turn_queue_start;
+    int turn_queue_count;
     int length;
     snake_behavior_t* behavior;
     bool should_grow;
+    grid_t* grid;           // Optional occupancy grid kept in sync with the body
+    uint64_t hash;          // Zobrist keys of the body cells and the head, see zobrist.h
+    arena_t* arena;         // Owner of the memory, NULL for the heap
 };
 
 // Snake creation and destruction
-snake_t* snake_create(int start_x, int start_y, direction_t initial_dir);
+snake_t* snake_create(int start_x, int start_y, direction_t initial_dir, int capacity,
+                      arena_t* arena);
 void snake_destroy(snake_t* snake);
 
 // Snake behavior functions
@@ -33,12 +41,16 @@ void snake_grow_normal(snake_t* snake);
 
 // Snake operations
 void snake_set_direction(snake_t* snake, direction_t new_dir);
+void snake_clear_turns(snake_t* snake);
 void snake_add_segment(snake_t* snake, point_t position);
 void snake_remove_tail(snake_t* snake);
 void snake_reset_position(snake_t* snake, int x, int y, direction_t dir);
+void snake_attach_grid(snake_t* snake, grid_t* grid);
 
 // Snake queries
 point_t snake_get_head_position(snake_t* snake);
+point_t snake_get_tail_position(snake_t* snake);
+point_t snake_get_segment(snake_t* snake, int index);
 bool snake_contains_point(snake_t* snake, point_t point);
 bool snake_head_collides_with_body(snake_t* snake);
 
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 200809L
+#include "transposition.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRANSPOSITION_CACHE_LINE 64
+
+/******************************************************************************
+ * @brief 打包访问次数和价值之和
+ *****************************************************************************/
+static inline uint64_t transposition_pack(uint32_t visits, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (uint64_t)visits << 32 | bits;
+}
+
+/******************************************************************************
+ * @brief 拆开访问次数和价值之和
+ *****************************************************************************/
+static inline void transposition_unpack(uint64_t data, uint32_t* visits, float* value) {
+    uint32_t bits = (uint32_t)data;
+    *visits = (uint32_t)(data >> 32);
+    memcpy(value, &bits, sizeof(bits));
+}
+
+/******************************************************************************
+ * @brief 创建置换表
+ * 
+ * 条目按缓存行对齐，每行 4 个条目
+ * 
+ * @param bits 条目数的以 2 为底的对数（1 到 TRANSPOSITION_MAX_BITS）
+ * @return transposition_table_t* 置换表指针，失败返回 NULL
+ *****************************************************************************/
+transposition_table_t* transposition_table_create(int bits) {
+    if (bits < 1 || bits > TRANSPOSITION_MAX_BITS) return NULL;
+
+    transposition_table_t* table = malloc(sizeof(transposition_table_t));
+    if (!table) return NULL;
+
+    size_t count = (size_t)1 << bits;
+    void* memory = NULL;
+    if (posix_memalign(&memory, TRANSPOSITION_CACHE_LINE,
+                       sizeof(transposition_entry_t) * count) != 0) {
+        free(table);
+        return NULL;
+    }
+
+    table->bits = bits;
+    table->mask = count - 1;
+    table->entries = memory;
+    transposition_table_clear(table);
+    return table;
+}
+
+/******************************************************************************
+ * @brief 销毁置换表
+ * 
+ * @param table 置换表指针
+ *****************************************************************************/
+void transposition_table_destroy(transposition_table_t* table) {
+    if (!table) return;
+
+    free(table->entries);
+    free(table);
+}
+
+/******************************************************************************
+ * @brief 清空置换表
+ * 
+ * 不能与其他线程的访问同时进行
+ * 
+ * @param table 置换表指针
+ *****************************************************************************/
+void transposition_table_clear(transposition_table_t* table) {
+    if (!table) return;
+
+    memset(table->entries, 0, sizeof(transposition_entry_t) * (table->mask + 1));
+}
+
+/******************************************************************************
+ * @brief 查找局面的统计数据
+ * 
+ * @param table 置换表指针
+ * @param hash 局面哈希值
+ * @param visits 输出访问次数
+ * @param value 输出价值之和
+ * @return bool 找到返回 true
+ *****************************************************************************/
+bool transposition_table_probe(transposition_table_t* table, uint64_t hash,
+                               uint32_t* visits, float* value) {
+    transposition_entry_t* entry = &table->entries[hash & table->mask];
+    uint64_t check = __atomic_load_n(&entry->check, __ATOMIC_RELAXED);
+    uint64_t data = __atomic_load_n(&entry->data, __ATOMIC_RELAXED);
+
+    if ((check ^ data) != hash || data == 0) return false;
+
+    transposition_unpack(data, visits, value);
+    return true;
+}
+
+/******************************************************************************
+ * @brief 把一次估值累加到局面的统计数据
+ * 
+ * 槽位属于其他局面时直接替换
+ * 
+ * @param table 置换表指针
+ * @param hash 局面哈希值
+ * @param value 本次估值
+ *****************************************************************************/
+void transposition_table_add(transposition_table_t* table, uint64_t hash, float value) {
+    uint32_t visits = 0;
+    float sum = 0.0f;
+    if (!transposition_table_probe(table, hash, &visits, &sum)) {
+        visits = 0;
+        sum = 0.0f;
+    }
+    if (visits == UINT32_MAX) return;
+
+    transposition_entry_t* entry = &table->entries[hash & table->mask];
+    uint64_t data = transposition_pack(visits + 1, sum + value);
+    __atomic_store_n(&entry->data, data, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->check, hash ^ data, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Largest table accepted, in log2 of the entry count (16 bytes each)
+#define TRANSPOSITION_MAX_BITS  26
+
+typedef struct transposition_table transposition_table_t;
+
+// One slot: search statistics of a position. `check` holds the position's
+// hash XORed with `data`, so a reader that sees the two words from
+// different writers gets a check mismatch and treats the slot as empty.
+// No locks are taken and a racing update may be lost, which is harmless
+// for visit and value statistics.
+typedef struct {
+    uint64_t check;
+    uint64_t data;          // visits << 32 | bits of the float value sum
+} transposition_entry_t;
+
+// Fixed-size, always-replace hash table indexed by the low bits of the
+// hash. Threads share it directly; all accesses are relaxed atomics.
+struct transposition_table {
+    int bits;
+    uint64_t mask;          // Entry count - 1
+    transposition_entry_t* entries;
+};
+
+// Table management
+transposition_table_t* transposition_table_create(int bits);
+void transposition_table_destroy(transposition_table_t* table);
+void transposition_table_clear(transposition_table_t* table);
+
+// Access
+bool transposition_table_probe(transposition_table_t* table, uint64_t hash,
+                               uint32_t* visits, float* value);
+void transposition_table_add(transposition_table_t* table, uint64_t hash, float value);
+
+#endif // TRANSPOSITION_H
@@ -3,20 +3,55 @@
 #include "food.h"
 #include "score.h"
 #include "input.h"
+#include "frame_stats.h"
 #include <ncurses.h>
 #include <string.h>
 #include <stdio.h>
 
+// ncurses drawing primitives
+static void ncurses_clear_screen(void);
+static void ncurses_refresh_screen(void);
+static void ncurses_draw_border(int width, int height, int offset_x, int offset_y);
+static void ncurses_draw_text(int x, int y, const char* text, int color_pair);
+static void ncurses_draw_char(int x, int y, char ch, int color_pair);
+static void ncurses_get_size(int* width, int* height);
+
 // Static renderer instance
 static renderer_t ncurses_renderer = {
     .init = ui_init,
     .cleanup = ui_cleanup,
-    .clear_screen = ui_clear_screen,
-    .draw_border = ui_draw_border,
-    .draw_text = ui_draw_text,
-    .refresh = ui_refresh_screen
+    .clear_screen = ncurses_clear_screen,
+    .draw_border = ncurses_draw_border,
+    .draw_text = ncurses_draw_text,
+    .draw_char = ncurses_draw_char,
+    .get_size = ncurses_get_size,
+    .refresh = ncurses_refresh_screen,
+    .read_key = input_get_key
 };
 
+// Renderer all UI drawing goes through
+static renderer_t* active_renderer = &ncurses_renderer;
+
+// Time spent in the renderer's refresh since ui_take_refresh_ns last ran
+static int64_t refresh_ns;
+
+// What the game screen currently shows, used to redraw only changed cells
+static struct {
+    bool valid;             // false forces a full redraw on the next frame
+    int term_width;
+    int term_height;
+    point_t head;
+    point_t tail;
+    int length;
+    point_t food;
+    bool food_active;
+    int score;
+    int high_score;
+} drawn_game;
+
+// The game the game over screen is showing, as submitted to the leaderboard
+static leaderboard_record_t game_over_result;
+
 // State handlers
 static void start_screen_update(game_t* game);
 static void start_screen_render(game_t* game);
@@ -98,23 +133,142 @@ void ui_setup_colors(void) {
     }
 }
 
+/******************************************************************************
+ * @brief ncurses 清屏
+ *****************************************************************************/
+static void ncurses_clear_screen(void) {
+    clear();
+}
+
+/******************************************************************************
+ * @brief ncurses 刷新屏幕显示
+ *****************************************************************************/
+static void ncurses_refresh_screen(void) {
+    refresh();
+}
+
+/******************************************************************************
+ * @brief 获取 ncurses 屏幕尺寸
+ * 
+ * @param width 输出参数 - 屏幕宽度（列数）
+ * @param height 输出参数 - 屏幕高度（行数）
+ *****************************************************************************/
+static void ncurses_get_size(int* width, int* height) {
+    int term_width, term_height;
+    getmaxyx(stdscr, term_height, term_width);
+    *width = term_width;
+    *height = term_height;
+}
+
+/******************************************************************************
+ * @brief 设置 UI 绘制使用的渲染器
+ * 
+ * 屏幕绘制函数都通过该渲染器输出，可替换为无终端的渲染器
+ * 
+ * @param renderer 渲染器指针，NULL 表示恢复为 ncurses 渲染器
+ *****************************************************************************/
+void ui_set_renderer(renderer_t* renderer) {
+    active_renderer = renderer ? renderer : &ncurses_renderer;
+}
+
 /******************************************************************************
  * @brief 清屏
  *****************************************************************************/
 void ui_clear_screen(void) {
-    clear();
+    active_renderer->clear_screen();
 }
 
 /******************************************************************************
  * @brief 刷新屏幕显示
+ * 
+ * 刷新耗时累加到帧统计的 refresh 阶段
  *****************************************************************************/
 void ui_refresh_screen(void) {
-    refresh();
+    int64_t start = time_now_ns();
+    (active_renderer->refresh)(); // Parenthesised: ncurses defines refresh() as a macro
+    refresh_ns += time_now_ns() - start;
+}
+
+/******************************************************************************
+ * @brief 取出并清零累计的屏幕刷新耗时
+ * 
+ * @return int64_t 上次调用以来刷新屏幕花费的纳秒数
+ *****************************************************************************/
+int64_t ui_take_refresh_ns(void) {
+    int64_t elapsed = refresh_ns;
+    refresh_ns = 0;
+    return elapsed;
+}
+
+/******************************************************************************
+ * @brief 读取下一个按键
+ * 
+ * 按键由当前渲染器读取，它掌管着终端
+ * 
+ * @return int 按键值，无输入或渲染器不读取按键时返回 ERR
+ *****************************************************************************/
+int ui_read_key(void) {
+    return active_renderer->read_key ? active_renderer->read_key() : ERR;
+}
+
+/******************************************************************************
+ * @brief 获取屏幕尺寸
+ * 
+ * @param width 输出参数 - 屏幕宽度（列数）
+ * @param height 输出参数 - 屏幕高度（行数）
+ *****************************************************************************/
+void ui_get_size(int* width, int* height) {
+    active_renderer->get_size(width, height);
+}
+
+/******************************************************************************
+ * @brief 使游戏屏幕缓存失效
+ * 
+ * 下一帧游戏屏幕将完整重绘（状态切换、重新开局时调用）
+ *****************************************************************************/
+void ui_invalidate(void) {
+    drawn_game.valid = false;
 }
 
 /******************************************************************************
  * @brief 绘制游戏区域边框
  * 
+ * @param width 区域宽度
+ * @param height 区域高度
+ * @param offset_x X 偏移量
+ * @param offset_y Y 偏移量
+ *****************************************************************************/
+void ui_draw_border(int width, int height, int offset_x, int offset_y) {
+    active_renderer->draw_border(width, height, offset_x, offset_y);
+}
+
+/******************************************************************************
+ * @brief 在指定位置绘制文本
+ * 
+ * @param x X 坐标
+ * @param y Y 坐标
+ * @param text 要绘制的文本
+ * @param color_pair 颜色对编号，0 表示不使用颜色
+ *****************************************************************************/
+void ui_draw_text(int x, int y, const char* text, int color_pair) {
+    active_renderer->draw_text(x, y, text, color_pair);
+}
+
+/******************************************************************************
+ * @brief 在指定位置绘制字符
+ * 
+ * @param x X 坐标
+ * @param y Y 坐标
+ * @param ch 要绘制的字符
+ * @param color_pair 颜色对编号
+ *****************************************************************************/
+void ui_draw_char(int x, int y, char ch, int color_pair) {
+    active_renderer->draw_char(x, y, ch, color_pair);
+}
+
+/******************************************************************************
+ * @brief ncurses 绘制游戏区域边框
+ * 
  * 使用 '=' 绘制水平边框，'|' 绘制垂直边框
  * 
  * @param width 区域宽度
@@ -122,7 +276,7 @@ void ui_refresh_screen(void) {
  * @param offset_x X 偏移量
  * @param offset_y Y 偏移量
  *****************************************************************************/
-void ui_draw_border(int width, int height, int offset_x, int offset_y) {
+static void ncurses_draw_border(int width, int height, int offset_x, int offset_y) {
     attron(COLOR_PAIR(COLOR_WALL));
 
     // Draw horizontal borders
@@ -141,14 +295,14 @@ void ui_draw_border(int width, int height, int offset_x, int offset_y) {
 }
 
 /******************************************************************************
- * @brief 在指定位置绘制文本
+ * @brief ncurses 在指定位置绘制文本
  * 
  * @param x X 坐标
  * @param y Y 坐标
  * @param text 要绘制的文本
  * @param color_pair 颜色对编号，0 表示不使用颜色
  *****************************************************************************/
-void ui_draw_text(int x, int y, const char* text, int color_pair) {
+static void ncurses_draw_text(int x, int y, const char* text, int color_pair) {
     if (color_pair > 0) {
         attron(COLOR_PAIR(color_pair));
     }
@@ -169,21 +323,21 @@ void ui_draw_text(int x, int y, const char* text, int color_pair) {
  *****************************************************************************/
 void ui_draw_text_centered(int y, const char* text, int color_pair) {
     int term_width, term_height;
-    getmaxyx(stdscr, term_height, term_width);
+    ui_get_size(&term_width, &term_height);
     (void)term_height; // Suppress unused variable warning
     int x = (term_width - strlen(text)) / 2;
     ui_draw_text(x, y, text, color_pair);
 }
 
 /******************************************************************************
- * @brief 在指定位置绘制字符
+ * @brief ncurses 在指定位置绘制字符
  * 
  * @param x X 坐标
  * @param y Y 坐标
  * @param ch 要绘制的字符
  * @param color_pair 颜色对编号
  *****************************************************************************/
-void ui_draw_char(int x, int y, char ch, int color_pair) {
+static void ncurses_draw_char(int x, int y, char ch, int color_pair) {
     if (color_pair > 0) {
         attron(COLOR_PAIR(color_pair));
     }
@@ -205,14 +359,10 @@ void ui_draw_char(int x, int y, char ch, int color_pair) {
 void ui_draw_snake(snake_t* snake) {
     if (!snake) return;
 
-    snake_segment_t* current = snake->head;
-    bool is_head = true;
-
-    while (current) {
-        char symbol = is_head ? 'O' : '#';
-        ui_draw_char(current->position.x, current->position.y, symbol, COLOR_SNAKE);
-        current = current->next;
-        is_head = false;
+    for (int i = 0; i < snake->length; i++) {
+        point_t position = snake_get_segment(snake, i);
+        char symbol = (i == 0) ? 'O' : '#';
+        ui_draw_char(position.x, position.y, symbol, COLOR_SNAKE);
     }
 }
 
@@ -253,6 +403,30 @@ void ui_draw_score(game_t* game) {
     ui_draw_text(2, 3, level_text, COLOR_UI);
 }
 
+/******************************************************************************
+ * @brief 绘制帧耗时浮层
+ * 
+ * 在左侧信息栏分数下方列出每个阶段的 p50/p99/最大耗时（毫秒）。
+ * 每行宽度固定，逐帧覆盖绘制即可，无需擦除
+ * 
+ * @param stats 帧统计指针
+ *****************************************************************************/
+void ui_draw_frame_stats(const frame_stats_t* stats) {
+    if (!stats) return;
+
+    char line[64];
+    ui_draw_text(2, 5, "ms        p50   p99    max", COLOR_HIGHLIGHT);
+    for (int phase = 0; phase < FRAME_PHASE_COUNT; phase++) {
+        const frame_histogram_t* histogram = &stats->histograms[phase];
+        snprintf(line, sizeof(line), "%-8s%6.2f%6.2f%7.2f",
+                 frame_phase_name((frame_phase_t)phase),
+                 frame_histogram_percentile(histogram, 50) / 1e6,
+                 frame_histogram_percentile(histogram, 99) / 1e6,
+                 histogram->max / 1e6);
+        ui_draw_text(2, 6 + phase, line, COLOR_UI);
+    }
+}
+
 /******************************************************************************
  * @brief 绘制开始屏幕
  * 
@@ -264,7 +438,7 @@ void ui_render_start_screen(game_t* game) {
     if (!game) return;
 
     int term_width, term_height;
-    getmaxyx(stdscr, term_height, term_width);
+    ui_get_size(&term_width, &term_height);
     (void)term_width; // Suppress unused variable warning
 
     ui_clear_screen();
@@ -296,15 +470,99 @@ void ui_render_start_screen(game_t* game) {
 }
 
 /******************************************************************************
- * @brief 绘制游戏屏幕
+ * @brief 记录游戏屏幕当前显示的内容
  * 
- * 绘制游戏边框、分数、蛇、食物、操作提示
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void ui_remember_game_screen(game_t* game) {
+    drawn_game.valid = game->snake != NULL;
+    drawn_game.score = game->score;
+    drawn_game.high_score = game->high_score;
+
+    if (game->snake) {
+        drawn_game.head = snake_get_head_position(game->snake);
+        drawn_game.tail = snake_get_tail_position(game->snake);
+        drawn_game.length = game->snake->length;
+    }
+
+    drawn_game.food_active = game->food && game->food->active;
+    if (drawn_game.food_active) {
+        drawn_game.food = game->food->position;
+    }
+}
+
+/******************************************************************************
+ * @brief 增量更新游戏屏幕
+ * 
+ * 与上一帧相比，蛇每走一步只有以下格子发生变化：
+ * 1. 旧尾部被擦除（生长时除外）
+ * 2. 旧头部变为蛇身字符
+ * 3. 新头部
+ * 另外处理食物位置和分数的变化。蛇在两帧之间移动超过一步时
+ * 无法增量更新，返回 false 由调用者完整重绘
  * 
  * @param game 游戏实例指针
+ * @return bool 增量更新成功返回 true，需要完整重绘返回 false
  *****************************************************************************/
-void ui_render_game_screen(game_t* game) {
-    if (!game) return;
+static bool ui_update_game_screen(game_t* game) {
+    snake_t* snake = game->snake;
+    if (!snake) return false;
+
+    point_t head = snake_get_head_position(snake);
+    bool moved = !point_equals(head, drawn_game.head);
+    int grown = snake->length - drawn_game.length;
+
+    if (moved) {
+        // Only a single step since the last frame can be patched
+        if (grown < 0 || grown > 1) return false;
+        if (snake->length > 1 &&
+            !point_equals(snake_get_segment(snake, 1), drawn_game.head)) {
+            return false;
+        }
+
+        // Erase the old tail unless the snake grew or still covers it
+        if (grown == 0 && !snake_contains_point(snake, drawn_game.tail)) {
+            ui_draw_char(drawn_game.tail.x, drawn_game.tail.y, ' ', 0);
+        }
+    } else if (grown != 0) {
+        return false;
+    }
 
+    // Food moved or was eaten
+    food_t* food = game->food;
+    bool food_active = food && food->active;
+    if (drawn_game.food_active &&
+        (!food_active || !point_equals(food->position, drawn_game.food)) &&
+        !snake_contains_point(snake, drawn_game.food)) {
+        ui_draw_char(drawn_game.food.x, drawn_game.food.y, ' ', 0);
+    }
+    if (food_active && (!drawn_game.food_active ||
+                        !point_equals(food->position, drawn_game.food))) {
+        ui_draw_food(food);
+    }
+
+    if (moved) {
+        if (snake->length > 1) {
+            ui_draw_char(drawn_game.head.x, drawn_game.head.y, '#', COLOR_SNAKE);
+        }
+        ui_draw_char(head.x, head.y, 'O', COLOR_SNAKE);
+    }
+
+    if (game->score != drawn_game.score || game->high_score != drawn_game.high_score) {
+        ui_draw_score(game);
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * @brief 完整绘制游戏屏幕
+ * 
+ * 绘制游戏边框、分数、蛇、食物、操作提示
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+static void ui_draw_game_screen(game_t* game) {
     ui_clear_screen();
 
     // Draw game border
@@ -320,19 +578,131 @@ void ui_render_game_screen(game_t* game) {
 
     // Draw instructions
     int term_width, term_height;
-    getmaxyx(stdscr, term_height, term_width);
+    ui_get_size(&term_width, &term_height);
     (void)term_width; // Suppress unused variable warning
 
     ui_draw_text(2, term_height - 3, "Arrow Keys/WASD: Move", COLOR_UI);
     ui_draw_text(2, term_height - 2, "P/SPACE: Pause, ESC/Q: Menu", COLOR_UI);
+}
+
+/******************************************************************************
+ * @brief 绘制游戏屏幕
+ * 
+ * 边框和提示文字只在首帧、终端尺寸变化或状态切换后完整绘制一次，
+ * 之后每帧只重绘发生变化的格子
+ * 
+ * @param game 游戏实例指针
+ *****************************************************************************/
+void ui_render_game_screen(game_t* game) {
+    if (!game) return;
+
+    int term_width, term_height;
+    ui_get_size(&term_width, &term_height);
+
+    bool resized = term_width != drawn_game.term_width ||
+                   term_height != drawn_game.term_height;
+    if (!drawn_game.valid || resized || !ui_update_game_screen(game)) {
+        ui_draw_game_screen(game);
+        drawn_game.term_width = term_width;
+        drawn_game.term_height = term_height;
+    }
+    ui_remember_game_screen(game);
+
+    if (game->frame_stats && game->frame_stats->overlay) {
+        ui_draw_frame_stats(game->frame_stats);
+    }
 
     ui_refresh_screen();
 }
 
+/******************************************************************************
+ * @brief 绘制排行榜的一行
+ * 
+ * @param y Y 坐标（行）
+ * @param rank 名次，0 表示未知（显示为 "--"）
+ * @param record 记录
+ * @param color_pair 颜色对编号
+ *****************************************************************************/
+static void ui_draw_leaderboard_row(int y, int rank, const leaderboard_record_t* record,
+                                    int color_pair) {
+    char rank_text[8] = "--";
+    if (rank > 0) snprintf(rank_text, sizeof(rank_text), "%2d", rank);
+
+    char line[96];
+    long seconds = (long)(record->duration_ms / 1000);
+    snprintf(line, sizeof(line), "%s. %-15.15s %6d %5d %4ld:%02ld  %-20llu",
+             rank_text, record->name, record->score, record->length,
+             seconds / 60, seconds % 60, (unsigned long long)record->seed);
+    ui_draw_text_centered(y, line, color_pair);
+}
+
+/******************************************************************************
+ * @brief 绘制一个等级的排行榜
+ * 
+ * 直接从共享映射读取记录，不复制。刚结束的一局由后台线程提交，
+ * 可能还没写入文件：这时把它作为虚拟行按名次插入显示。无论是否
+ * 已写入，这一局都高亮。
+ * 
+ * 渲染线程不等待文件锁：排行榜正在被写入时只显示这一局（名次未知），
+ * 并返回 false 让调用者稍后重绘
+ * 
+ * @param level 难度等级
+ * @param first_y 标题所在行，下一行是列名
+ * @param last_y 最后可用的行
+ * @return bool 完整绘制（或没有排行榜）返回 true，排行榜正忙返回 false
+ *****************************************************************************/
+static bool ui_render_leaderboard(int level, int first_y, int last_y) {
+    int rows = last_y - first_y - 1;
+    leaderboard_t* board = score_get_leaderboard();
+    if (rows < 1 || !board) return true;
+    if (rows > LEADERBOARD_ENTRIES) rows = LEADERBOARD_ENTRIES;
+
+    char title[64];
+    snprintf(title, sizeof(title), "Level %d Top %d", level, LEADERBOARD_ENTRIES);
+    ui_draw_text_centered(first_y, title, COLOR_HIGHLIGHT);
+    ui_draw_text_centered(first_y + 1,
+                          "    Name             Score   Len    Time  Seed                ", COLOR_UI);
+
+    const leaderboard_record_t* current =
+        game_over_result.level == level ? &game_over_result : NULL;
+
+    int count;
+    const leaderboard_record_t* records = leaderboard_try_read_level(board, level, &count);
+    if (!records) {
+        if (current) {
+            ui_draw_leaderboard_row(first_y + 2, 0, current, COLOR_HIGHLIGHT);
+        }
+        return false;
+    }
+
+    for (int i = 0; current && i < count; i++) {
+        if (leaderboard_record_equals(&records[i], current)) current = NULL;
+    }
+
+    // Merge the unsubmitted game after the records with an equal or higher score
+    int shown = 0;
+    for (int i = 0; shown < rows && (i < count || current); ) {
+        const leaderboard_record_t* record;
+        if (current && (i == count || records[i].score < current->score)) {
+            record = current;
+            current = NULL;
+        } else {
+            record = &records[i++];
+        }
+        bool highlight = leaderboard_record_equals(record, &game_over_result);
+        ui_draw_leaderboard_row(first_y + 2 + shown, shown + 1, record,
+                                highlight ? COLOR_HIGHLIGHT : COLOR_UI);
+        shown++;
+    }
+
+    leaderboard_read_done(board);
+    return true;
+}
+
 /******************************************************************************
  * @brief 绘制游戏结束屏幕
  * 
- * 显示游戏结束标题、最终分数、历史最高分、重新开始选项
+ * 显示游戏结束标题（占满棋盘时为获胜标题）、最终分数、历史最高分、本等级排行榜、重新开始选项
  * 
  * @param game 游戏实例指针
  *****************************************************************************/
@@ -340,13 +710,14 @@ void ui_render_game_over_screen(game_t* game) {
     if (!game) return;
 
     int term_width, term_height;
-    getmaxyx(stdscr, term_height, term_width);
+    ui_get_size(&term_width, &term_height);
     (void)term_width; // Suppress unused variable warning
 
     ui_clear_screen();
 
     // Draw game over title
-    ui_draw_text_centered(term_height / 3, "GAME OVER", COLOR_HIGHLIGHT);
+    ui_draw_text_centered(term_height / 3, game->won ? "BOARD CLEARED!" : "GAME OVER",
+                          COLOR_HIGHLIGHT);
 
     // Draw scores
     char final_score[64];
@@ -361,6 +732,11 @@ void ui_render_game_over_screen(game_t* game) {
         ui_draw_text_centered(term_height / 3 + 5, "NEW HIGH SCORE!", COLOR_HIGHLIGHT);
     }
 
+    // Try again on a later frame while the leaderboard is being written
+    if (!ui_render_leaderboard(game->level, term_height / 3 + 7, term_height - 8)) {
+        game_mark_dirty(game, RENDER_DIRTY_RETRY);
+    }
+
     // Draw options
     ui_draw_text_centered(term_height - 6, "Press ENTER/SPACE/R to play again", COLOR_UI);
     ui_draw_text_centered(term_height - 5, "Press ESC/M for main menu", COLOR_UI);
@@ -396,32 +772,10 @@ static void start_screen_exit(game_t* game) {
 }
 
 static void game_screen_update(game_t* game) {
-    if (!game || !game->snake) return;
-
-    // Move snake
-    if (game->snake->behavior && game->snake->behavior->move_snake) {
-        game->snake->behavior->move_snake(game->snake, game);
-    }
-
-    // Check food collision
-    if (game->food && game->food->active) {
-        point_t head_pos = snake_get_head_position(game->snake);
-        if (food_is_at_position(game->food, head_pos)) {
-            food_consume(game->food, game);
-            food_spawn(game->food, game);
-        }
-    }
+    if (!game) return;
 
-    // Check collisions
-    if (game->snake->behavior && game->snake->behavior->check_collision) {
-        if (game->snake->behavior->check_collision(game->snake, game)) {
-            game_set_state(game, STATE_GAME_OVER);
-            // Save high score if it's a new record
-            if (score_is_new_high_score(game->score)) {
-                score_save_high_score(game->score);
-            }
-        }
-    }
+    // A death switches to the game over screen, which saves the high score
+    game_tick(game);
 }
 
 static void game_screen_render(game_t* game) {
@@ -434,7 +788,8 @@ static void game_screen_handle_input(game_t* game, int key) {
 
 static void game_screen_enter(game_t* game) {
     (void)game; // Suppress unused parameter warning
-    // Nothing special to do when entering game state
+    // Start from a full redraw; later frames only patch changed cells
+    ui_invalidate();
 }
 
 static void game_screen_exit(game_t* game) {
@@ -456,7 +811,9 @@ static void game_over_screen_handle_input(game_t* game, int key) {
 }
 
 static void game_over_screen_enter(game_t* game) {
-    // Save high score when entering game over state
+    // Queue the high score and the game for the background writer, never
+    // blocks on I/O
+    score_submit_result(game, &game_over_result);
     if (score_is_new_high_score(game->score)) {
         score_save_high_score(game->score);
         game->high_score = game->score;
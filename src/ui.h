@@ -12,6 +12,11 @@ void ui_setup_colors(void);
 // Screen management
 void ui_clear_screen(void);
 void ui_refresh_screen(void);
+void ui_invalidate(void);
+void ui_get_size(int* width, int* height);
+void ui_set_renderer(renderer_t* renderer);
+int64_t ui_take_refresh_ns(void);
+int ui_read_key(void);
 
 // Drawing primitives
 void ui_draw_border(int width, int height, int offset_x, int offset_y);
@@ -23,6 +28,7 @@ void ui_draw_char(int x, int y, char ch, int color_pair);
 void ui_draw_snake(snake_t* snake);
 void ui_draw_food(food_t* food);
 void ui_draw_score(game_t* game);
+void ui_draw_frame_stats(const frame_stats_t* stats);
 
 // Screen-specific rendering
 void ui_render_start_screen(game_t* game);
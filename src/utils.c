@@ -1,37 +1,12 @@
 #define _POSIX_C_SOURCE 200809L
 #include "utils.h"
-#include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <stdio.h>
-
-/******************************************************************************
- * @brief 初始化随机数生成器
- * 
- * 使用当前时间作为种子初始化随机数生成器
- *****************************************************************************/
-void init_random(void) {
-    srand((unsigned int)time(NULL));
-}
-
-/******************************************************************************
- * @brief 生成指定范围内的随机数
- * 
- * 生成 [min, max] 范围内的随机整数（包含边界）
- * 
- * @param min 最小值
- * @param max 最大值
- * @return int 随机数
- *****************************************************************************/
-int get_random(int min, int max) {
-    if (min > max) {
-        int temp = min;
-        min = max;
-        max = temp;
-    }
-    return min + rand() % (max - min + 1);
-}
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
 
 /******************************************************************************
  * @brief 获取终端尺寸
@@ -66,6 +41,42 @@ bool is_terminal_size_valid(void) {
     return width >= MIN_TERMINAL_WIDTH && height >= MIN_TERMINAL_HEIGHT;
 }
 
+/******************************************************************************
+ * @brief 获取文件所在的目录
+ * 
+ * @param path 文件路径
+ * @param dir 输出缓冲区
+ * @param size 缓冲区大小
+ * @return bool 成功返回 true，路径过长返回 false；没有目录部分时为 "."
+ *****************************************************************************/
+bool get_parent_dir(const char* path, char* dir, size_t size) {
+    const char* slash = strrchr(path, '/');
+    size_t length = slash ? (size_t)(slash - path) : 0;
+    if (slash == path) length = 1; // Root directory
+
+    if (!slash) {
+        if (size < 2) return false;
+        strcpy(dir, ".");
+        return true;
+    }
+    if (length >= size) return false;
+    memcpy(dir, path, length);
+    dir[length] = '\0';
+    return true;
+}
+
+/******************************************************************************
+ * @brief 创建文件所在的目录（只创建最后一级）
+ * 
+ * @param path 文件路径
+ * @return bool 目录已存在或创建成功返回 true
+ *****************************************************************************/
+bool make_parent_dir(const char* path) {
+    char dir[256];
+    if (!get_parent_dir(path, dir, sizeof(dir))) return false;
+    return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
 /******************************************************************************
  * @brief 休眠指定毫秒数
  * 
@@ -80,6 +91,35 @@ void sleep_ms(int milliseconds) {
     nanosleep(&ts, NULL);
 }
 
+/******************************************************************************
+ * @brief 获取单调时钟当前时间
+ * 
+ * 基于 CLOCK_MONOTONIC，不受系统时间调整影响，用于游戏节拍计时
+ * 
+ * @return int64_t 当前时间（纳秒）
+ *****************************************************************************/
+int64_t time_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/******************************************************************************
+ * @brief 休眠到指定的单调时钟时间点
+ * 
+ * 使用绝对时间休眠，避免相对休眠累积误差；时间点已过则立即返回
+ * 
+ * @param deadline_ns 目标时间点（纳秒，CLOCK_MONOTONIC）
+ *****************************************************************************/
+void sleep_until_ns(int64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = deadline_ns / 1000000000LL;
+    ts.tv_nsec = deadline_ns % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        // Interrupted by a signal (e.g. SIGWINCH), keep sleeping
+    }
+}
+
 /******************************************************************************
  * @brief 创建点
  * 
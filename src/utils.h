@@ -2,6 +2,8 @@
 #define UTILS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 // Basic data types
 typedef struct {
@@ -28,13 +30,18 @@ typedef enum {
 #define MIN_TERMINAL_HEIGHT 20
 #define MAX_LEVELS          5
 #define HIGHSCORE_FILE      "data/highscore.txt"
+#define LEADERBOARD_FILE    "data/leaderboard.dat"
 
 // Utility functions
-void init_random(void);
-int get_random(int min, int max);
 void get_terminal_size(int* width, int* height);
 bool is_terminal_size_valid(void);
 void sleep_ms(int milliseconds);
+bool make_parent_dir(const char* path);
+bool get_parent_dir(const char* path, char* dir, size_t size);
+
+// Monotonic time utilities
+int64_t time_now_ns(void);
+void sleep_until_ns(int64_t deadline_ns);
 
 // Point utilities
 point_t point_create(int x, int y);
@@ -0,0 +1,52 @@
+#include "zobrist.h"
+#include "snake.h"
+#include "food.h"
+
+/******************************************************************************
+ * @brief 获取当前局面的哈希值（O(1)）
+ * 
+ * 蛇身和蛇头的键由蛇移动时增量维护，食物的键由生成食物时维护，
+ * 这里再合并方向和待生长标记
+ * 
+ * @param game 游戏实例指针
+ * @return uint64_t 局面哈希值，没有蛇时返回 0
+ *****************************************************************************/
+uint64_t zobrist_game_hash(game_t* game) {
+    if (!game || !game->snake) return 0;
+
+    snake_t* snake = game->snake;
+    uint64_t hash = snake->hash ^ zobrist_key(ZOBRIST_DIRECTION, snake->direction, 0);
+    if (snake->should_grow) {
+        hash ^= zobrist_key(ZOBRIST_GROW, 0, 0);
+    }
+    if (game->food) {
+        hash ^= game->food->hash;
+    }
+    return hash;
+}
+
+/******************************************************************************
+ * @brief 遍历整条蛇从头计算局面哈希值（O(蛇长)）
+ * 
+ * 结果应与 zobrist_game_hash 相同，用于校验增量维护
+ * 
+ * @param game 游戏实例指针
+ * @return uint64_t 局面哈希值，没有蛇时返回 0
+ *****************************************************************************/
+uint64_t zobrist_compute_game_hash(game_t* game) {
+    if (!game || !game->snake) return 0;
+
+    snake_t* snake = game->snake;
+    uint64_t hash = zobrist_point_key(ZOBRIST_HEAD, snake_get_head_position(snake)) ^
+                    zobrist_key(ZOBRIST_DIRECTION, snake->direction, 0);
+    for (int i = 0; i < snake->length; i++) {
+        hash ^= zobrist_point_key(ZOBRIST_BODY, snake_get_segment(snake, i));
+    }
+    if (snake->should_grow) {
+        hash ^= zobrist_key(ZOBRIST_GROW, 0, 0);
+    }
+    if (game->food && game->food->active) {
+        hash ^= zobrist_point_key(ZOBRIST_FOOD, game->food->position);
+    }
+    return hash;
+}
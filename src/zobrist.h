@@ -0,0 +1,43 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "game.h"
+#include "utils.h"
+#include <stdint.h>
+
+// Zobrist hashing of game positions. A position hashes to the XOR of one
+// 64-bit key per feature: every body cell, the head cell, the direction,
+// a pending growth and the food cell. A move changes a handful of
+// features, so the hash is updated with a few XORs instead of rehashing.
+//
+// Keys are not stored in tables sized to the board: each one is a
+// splitmix64 mix of its kind and screen coordinates. They need no setup,
+// work for any board size and are the same in every process, and a search
+// can fill per-cell key tables from them for its own snapshots.
+typedef enum {
+    ZOBRIST_BODY,
+    ZOBRIST_HEAD,
+    ZOBRIST_FOOD,
+    ZOBRIST_DIRECTION,
+    ZOBRIST_GROW
+} zobrist_kind_t;
+
+#define ZOBRIST_SEED 0x2545F4914F6CDD1DULL
+
+static inline uint64_t zobrist_key(zobrist_kind_t kind, int x, int y) {
+    uint64_t z = ZOBRIST_SEED ^ ((uint64_t)kind << 48) ^
+                 ((uint64_t)(uint16_t)y << 16) ^ (uint16_t)x;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t zobrist_point_key(zobrist_kind_t kind, point_t p) {
+    return zobrist_key(kind, p.x, p.y);
+}
+
+// Position hashes
+uint64_t zobrist_game_hash(game_t* game);
+uint64_t zobrist_compute_game_hash(game_t* game);
+
+#endif // ZOBRIST_H